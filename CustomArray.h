@@ -5,7 +5,25 @@
 #include <cstddef>  // std::size_t
 #include <utility>  // std::swap, std::initializer_list
 #include <iterator> // std::forward_iterator_tag
+#include <algorithm> // std::move_backward, std::fill
 #include <cassert>
+#include <memory>      // std::unique_ptr, std::allocator, std::allocator_traits
+#include <thread>      // std::thread
+#include <system_error> // std::system_error
+#include <exception>   // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <cstdint>     // std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>     // std::memcpy
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::conditional, std::is_integral, std::is_floating_point
+#include "CustomSimd.h"
+#include "CustomBloomFilter.h"
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#include <memory_resource> // std::pmr::polymorphic_allocator
+#define CUSTOMARRAY_PMR 1
+#endif
+#endif
 
 
 /*
@@ -20,6 +38,12 @@
  *   This file contains code for a custom array container in the form of a class template CustomArray.
  *   Member functions of the class are available to add, remove, or manipulate data.
  *   Friend functions of the class are available to apply basic probability set type operations.
+ *   The binary file format friend functions saveBinary and loadBinary are defined in CustomArrayFile.h.
+ *   CustomArrayView.h defines a non-owning view of a range of elements, accepted by merge and the set operations.
+ *
+ *   Memory is obtained from an Allocator template parameter, which defaults to std::allocator<T>.
+ *   When compiled as C++17, CustomPmrArray<T> is an array that uses std::pmr::polymorphic_allocator<T>,
+ *   so it can be placed in a std::pmr::memory_resource such as a std::pmr::monotonic_buffer_resource.
  *
  *   The template class has been tested with the following data types:
  *     * Integers
@@ -47,36 +71,160 @@
  *
  *     m_length
  *       An unsigned integer (std::size_t) that tracks the number of elements in the array.
+ *     m_capacity
+ *       An unsigned integer (std::size_t) that tracks the number of elements the allocated memory can hold.
+ *     m_front
+ *       An unsigned integer (std::size_t) that tracks the number of unused elements before the first array element.
+ *     m_sort_state
+ *       A SortState that records whether the elements are known to be in ascending order, known not to be, or unknown.
+ *     m_revision
+ *       An unsigned integer (std::size_t) that is incremented whenever the elements may have changed.
+ *     m_bloom_ptr
+ *       A unique pointer to an optional CustomBloomFilter of the elements, used by search to reject missing values.
+ *     m_bloom_revision
+ *       The revision at which the Bloom filter was last up to date.
  *     m_array_ptr
- *       A pointer to dynamic array created in heap memory.
+ *       A pointer to dynamic array created in heap memory. Only the first m_length elements are constructed.
+ *     m_allocator
+ *       An Allocator object that allocates, constructs, destroys and deallocates the dynamic array.
  *
  *
  *   Member Functions:
  *
  *     isNull
  *       Checks if m_array is a null pointer.
+ *     allocateBuffer
+ *       Allocates uninitialised memory for the specified number of elements using m_allocator.
+ *     deallocateBuffer
+ *       Deallocates memory allocated by allocateBuffer.
+ *     constructCopies, constructMoves, constructValues
+ *       Construct elements in uninitialised memory.
+ *     destroyRange
+ *       Destroys elements, leaving uninitialised memory.
+ *     selectAllocator
+ *       Returns the allocator for a new array made from the array.
+ *     propagateAllocator
+ *       Copies the allocator of another array on copy assignment, if the Allocator type requires it.
+ *     swapAllocator
+ *       Swaps allocators with another array on swap or move assignment, if the Allocator type requires it.
+ *     swapData
+ *       Swaps the array data, but not the allocator, with another array.
+ *     recordInsert
+ *       Updates m_sort_state before a value is inserted into the array.
+ *     recordErase
+ *       Updates m_sort_state after a value is removed from the array.
+ *     advanceRevision
+ *       Increments m_revision, keeping an up to date Bloom filter up to date.
+ *     refreshBloom
+ *       Rebuilds the Bloom filter from the elements if it is out of date.
  *     display
  *       Prints the array data to the specified output stream.
  *     deepCopy
  *       Performs a deep copy of another array.
+ *     reallocate
+ *       Moves the array data into a new portion of heap memory of the specified capacity.
+ *     nextCapacity
+ *       Returns the capacity to grow to when the allocated memory is full.
+ *     shiftData
+ *       Moves the array data within the allocated memory, leaving the specified number of unused elements before it.
+ *     relocateRange
+ *       Moves elements within the allocated memory, to a position that may overlap their current one.
+ *     clampPosition
+ *       Converts a position that may be negative or past the end of the array to an index.
+ *     recordInsertRange
+ *       Updates m_sort_state after several values are inserted into the array.
+ *     insertGap
+ *       Inserts a number of elements at the specified position, constructed by a function.
+ *     insertRange
+ *       Inserts the elements of an iterator range at the specified position.
+ *     constructFrom, constructFill
+ *       Construct elements in uninitialised memory from an iterator or from a value.
+ *     isMultiPass
+ *       Returns whether an iterator can be read more than once.
  *     linearSearch
- *       Searches linearly for the specified value.
+ *       Searches linearly for the specified value, many elements at a time for arithmetic types.
  *     binarySearch
  *       Searches through a sorted array using the binary search algorithm.
+ *     branchlessBound
+ *       Returns the number of leading elements of a sorted range for which a predicate is true, without branching.
+ *     interleavedLowerBounds
+ *       Finds the lower bound of each of several keys in a sorted range, several searches at a time.
+ *     pdqSort
+ *       Sorts a range of elements using the pattern-defeating quicksort algorithm.
+ *     partitionRight
+ *       Partitions a range around its first element, placing equal elements to the right.
+ *     partitionLeft
+ *       Partitions a range around its first element, placing equal elements to the left.
+ *     insertionSort
+ *       Sorts a small range of elements using the insertion sort algorithm.
+ *     partialInsertionSort
+ *       Attempts an insertion sort of a range, giving up if too many elements are out of place.
+ *     heapSort
+ *       Sorts a range of elements using the heapsort algorithm.
+ *     sort3
+ *       Sorts three elements in place.
+ *     radixKey
+ *       Maps an arithmetic element to an unsigned integer with the same ordering.
+ *     rangeLowerBound
+ *       Returns the first element of a sorted range that is not less than a value.
+ *     rangeUpperBound
+ *       Returns the first element of a sorted range that is greater than a value.
+ *     gallopLowerBound
+ *       Returns the first element of a sorted range that is not less than a value, searching from the start.
+ *     sortedOrCopy
+ *       Returns an array if it is sorted, or a sorted copy of it.
+ *     multiwaySplit
+ *       Finds where the element of a given rank splits each of several sorted ranges.
+ *     multiwayMerge
+ *       Merges several sorted ranges into one.
+ *     runParallel
+ *       Calls a function once per thread index, on separate threads.
+ *     parallelThreads
+ *       Returns the number of threads to use for an operation on a number of elements.
+ *     mergePathSplit
+ *       Returns how many elements of one sorted range are among the first elements of a merge with another.
+ *     mergeRanges, unionRanges, differenceRanges, intersectionRanges
+ *       Perform a merge or set operation on two sorted ranges, passing each output element to an output object.
+ *     unionSorted, differenceSorted, intersectionSorted
+ *       Append the union, difference or intersection of two sorted ranges to an array.
+ *     parallelSetOperation
+ *       Performs a set operation on two arrays using multiple threads.
+ *     parallelConstruct
+ *       Builds an array whose parts are constructed by separate threads.
+ *     sumRange, dotRange, minMaxRange, fillRange, transformRange
+ *       The engines of sum, dot, minMax, fill and transform, for both arrays and views.
  *     size
  *       Returns m_length
  *     empty
  *       Returns a bool False if m_length is zero. Else, returns True.
+ *     capacity
+ *       Returns m_capacity
+ *     data
+ *       Returns a pointer to the first element.
+ *     revision
+ *       Returns m_revision
+ *     invalidate
+ *       Records that the elements may have been changed through a reference, pointer or view kept from earlier.
+ *     reserve
+ *       Allocates memory for at least the specified number of elements.
+ *     shrinkToFit
+ *       Releases any allocated memory that is not used by the array elements.
  *     clear
  *       Removes the array data from memory and the array.
  *     resize
- *       Slow resize function. All elements are kept in the array up to the new length.
+ *       Resize function. All elements are kept in the array up to the new length.
  *     insert
- *       Inserts data into the array at the specified position.
+ *       Inserts data, a range of data or copies of a value into the array at the specified position.
+ *     emplace
+ *       Constructs a new element in place at the specified position.
  *     erase
- *       Removes data from the array at the specified position.
+ *       Removes data from the array at the specified position, or in the specified range of positions.
+ *     eraseIf
+ *       Removes every element for which a predicate is true.
  *     pushBack
  *       Appends a new value to the end of the array.
+ *     emplaceBack
+ *       Constructs a new element in place at the end of the array.
  *     pushFront
  *       Inserts a new value at the start of the array.
  *     popBack
@@ -85,23 +233,58 @@
  *       Removes an existing value from the start of the array.
  *     reverse
  *       Reverses the order of the array elements in place.
+ *     sort
+ *       Sorts the array in ascending order, or by a comparison function, in O(n log n).
  *     bubbleSort
- *       Sorts the array in ascending order using the bubblesort algorithm.
+ *       Legacy alias for sort.
+ *     radixSort
+ *       Sorts an array of integers or floating point numbers in ascending order using an LSD radix sort.
+ *     parallelSort
+ *       Sorts the array in ascending order using multiple threads.
  *     isSorted
  *       Function to state whether the array elements are in ascending order or not.
  *     search
  *       Searches the array for a specified value.
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     findAll
+ *       Returns the index of every element equal to a specified value.
+ *     lowerBound, upperBound
+ *       Return the index of the first element that is not less than, or greater than, a specified value.
+ *     equalRange
+ *       Returns the range of indexes of the elements equal to a specified value.
+ *     searchMany
+ *       Searches the array for each of several values, overlapping the searches in a sorted array.
+ *     enableBloomFilter, disableBloomFilter, hasBloomFilter
+ *       Adds, removes or checks for a Bloom filter of the elements, which answers searches for missing values.
+ *     mayContain
+ *       Returns false if the Bloom filter shows no element is equal to a specified value.
+ *     sum, mean
+ *       Returns the sum, or the arithmetic mean, of the elements.
+ *     minMax
+ *       Returns the least and greatest elements.
+ *     dot
+ *       Returns the dot product of this array and another.
+ *     transform
+ *       Replaces every element x with function(x).
+ *     fill
+ *       Assigns a value to every element.
  *     swap
  *       Swaps array data nodes with another array.
+ *     getAllocator
+ *       Returns a copy of m_allocator.
  *
  */
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class CustomArray;
 
+template <typename T>
+class CustomArrayView;
+
 /*
  *
- * template <typename T>
- * std::ostream& operator<<(std::ostream& out, const CustomArray<T>& arr);
+ * template <typename T, typename Allocator>
+ * std::ostream& operator<<(std::ostream& out, const CustomArray<T, Allocator>& arr);
  *
  * Summary:
  *
@@ -115,13 +298,13 @@ class CustomArray;
  *   Calls the private member function display.
  *
  */
-template <typename T>
-std::ostream& operator<<(std::ostream& out, const CustomArray<T>& arr);
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomArray<T, Allocator>& arr);
 
 /*
  *
- * template <typename T>
- * CustomArray<T> merge(const CustomArray<T>& A, const CustomArray<T>& B);
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> merge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
  *
  * Summary:
  *
@@ -136,13 +319,13 @@ std::ostream& operator<<(std::ostream& out, const CustomArray<T>& arr);
  *   Returns the combined array by value.
  *
  */
-template <typename T>
-CustomArray<T> merge(const CustomArray<T>& A, const CustomArray<T>& B);
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> merge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
 
 /*
  *
- * template <typename T>
- * CustomArray<T> setUnion(CustomArray<T> A, CustomArray<T> B);
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> setUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
  *
  * Summary:
  *
@@ -154,16 +337,19 @@ CustomArray<T> merge(const CustomArray<T>& A, const CustomArray<T>& B);
  *
  *   Function to return the union of two arrays that has friend privileges within the CustomArray class.
  *   Items within both arrays are sorted into ascending order and placed into a new combined array.
+ *   An array that is already sorted is used in place; an unsorted array is sorted in a temporary copy.
+ *   When one array is at least gallopRatio times longer, each element of the shorter array is found in
+ *   the longer one with gallopLowerBound, and the elements between are copied in bulk. O(m log(n/m)) comparisons.
  *   Returns the new combined array by value.
  *
  */
-template <typename T>
-CustomArray<T> setUnion(CustomArray<T> A, CustomArray<T> B);
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
 
 /*
  *
- * template <typename T>
- * CustomArray<T> setDifference(CustomArray<T> A, CustomArray<T> B);
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> setDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
  *
  * Summary:
  *
@@ -175,16 +361,19 @@ CustomArray<T> setUnion(CustomArray<T> A, CustomArray<T> B);
  *
  *   Function to return the difference between two arrays that has friend privileges within the CustomArray class.
  *   Items within both arrays are sorted into ascending order and placed into a new resulting array.
+ *   An array that is already sorted is used in place; an unsorted array is sorted in a temporary copy.
+ *   When one array is at least gallopRatio times longer, each element of the shorter array is found in
+ *   the longer one with gallopLowerBound. O(m log(n/m)) comparisons.
  *   Returns the new resulting array by value.
  *
  */
-template <typename T>
-CustomArray<T> setDifference(CustomArray<T> A, CustomArray<T> B);
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
 
 /*
  *
- * template <typename T>
- * CustomArray<T> setIntersection(CustomArray<T> A, CustomArray<T> B);
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> setIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
  *
  * Summary:
  *
@@ -196,798 +385,3980 @@ CustomArray<T> setDifference(CustomArray<T> A, CustomArray<T> B);
  *
  *   Function to return the intersection of two arrays that has friend privileges within the CustomArray class.
  *   Items within both arrays are sorted into ascending order and placed into a new resulting array.
+ *   An array that is already sorted is used in place; an unsorted array is sorted in a temporary copy.
+ *   When one array is at least gallopRatio times longer, each element of the shorter array is found in
+ *   the longer one with gallopLowerBound. O(m log(n/m)) comparisons.
  *   Returns the new resulting array by value.
  *
  */
-template <typename T>
-CustomArray<T> setIntersection(CustomArray<T> A, CustomArray<T> B);
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> parallelMerge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+ *
+ * Summary:
+ *
+ *    Combines two sorted arrays using multiple threads.
+ *
+ * Return Value: CustomArray result
+ *
+ * Description:
+ *
+ *   Function to merge two sorted arrays that has friend privileges within the CustomArray class.
+ *   Returns the same array as merge, which is combined into ascending order if A and B are sorted.
+ *   The output is split into one equal part per thread. The start of each part is found on the merge path
+ *   with a binary search of the diagonal, so each thread merges independent ranges of A and B into its
+ *   own precomputed part of the output, without locking.
+ *   Each element is copied once, directly into the result. If an element throws while being copied, or the
+ *   result cannot be allocated, the exception is rethrown and nothing is leaked.
+ *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+ *
+ */
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelMerge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> parallelSetUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+ *
+ * Summary:
+ *
+ *    Returns the set that is the union of arrays, using multiple threads.
+ *
+ * Return Value: CustomArray result
+ *
+ * Description:
+ *
+ *   Function that has friend privileges within the CustomArray class. Returns the same array as setUnion.
+ *   Unsorted arrays are sorted in a temporary copy using parallelSort.
+ *   The arrays are split with parallelSetOperation into one pair of independent ranges per thread.
+ *   Each thread counts the elements its ranges produce, then writes them at its offset in the output.
+ *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+ *
+ */
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> parallelSetDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+ *
+ * Summary:
+ *
+ *    Returns the set that is the difference (relative compliment) of two arrays, using multiple threads.
+ *
+ * Return Value: CustomArray result
+ *
+ * Description:
+ *
+ *   Function that has friend privileges within the CustomArray class. Returns the same array as setDifference.
+ *   Unsorted arrays are sorted in a temporary copy using parallelSort.
+ *   The arrays are split with parallelSetOperation into one pair of independent ranges per thread.
+ *   Each thread counts the elements its ranges produce, then writes them at its offset in the output.
+ *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+ *
+ */
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * CustomArray<T, Allocator> parallelSetIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+ *
+ * Summary:
+ *
+ *    Returns the set that is the intersection of two arrays, using multiple threads.
+ *
+ * Return Value: CustomArray result
+ *
+ * Description:
+ *
+ *   Function that has friend privileges within the CustomArray class. Returns the same array as setIntersection.
+ *   Unsorted arrays are sorted in a temporary copy using parallelSort.
+ *   The arrays are split with parallelSetOperation into one pair of independent ranges per thread.
+ *   Each thread counts the elements its ranges produce, then writes them at its offset in the output.
+ *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+ *
+ */
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads = 0);
+
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * void saveBinary(const CustomArray<T, Allocator>& arr, const char* path);
+ *
+ * Summary:
+ *
+ *    Writes an array to a file in the binary file format.
+ *
+ * Return Value: None
+ *
+ * Description:
+ *
+ *   Function that has friend privileges within the CustomArray class. Defined in CustomArrayFile.h.
+ *   Writes a CustomArrayFileHeader, holding the length and a checksum, and then the elements as they are in
+ *   memory, with a single writev call. Requires a trivially copyable element type.
+ *   Throws std::system_error if the file cannot be written.
+ *
+ */
+template <typename T, typename Allocator>
+void saveBinary(const CustomArray<T, Allocator>& arr, const char* path);
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * void loadBinary(CustomArray<T, Allocator>& arr, const char* path);
+ *
+ * Summary:
+ *
+ *    Replaces the elements of an array with those of a file written by saveBinary.
+ *
+ * Return Value: None
+ *
+ * Description:
+ *
+ *   Function that has friend privileges within the CustomArray class. Defined in CustomArrayFile.h.
+ *   Allocates a buffer of exactly the file's length once, and reads the elements straight into it.
+ *   Throws std::system_error if the file cannot be read, and std::runtime_error if the file holds another
+ *   element type or fails its checksum. The array is unchanged if an exception is thrown.
+ *
+ */
+template <typename T, typename Allocator>
+void loadBinary(CustomArray<T, Allocator>& arr, const char* path);
+
+/*
+ *
+ * template <typename U, typename V>
+ * CustomArray<typename std::remove_const<U>::type> merge(CustomArrayView<U> A, CustomArrayView<V> B);
+ * template <typename U, typename V>
+ * CustomArray<typename std::remove_const<U>::type> setUnion(CustomArrayView<U> A, CustomArrayView<V> B);
+ * template <typename U, typename V>
+ * CustomArray<typename std::remove_const<U>::type> setDifference(CustomArrayView<U> A, CustomArrayView<V> B);
+ * template <typename U, typename V>
+ * CustomArray<typename std::remove_const<U>::type> setIntersection(CustomArrayView<U> A, CustomArrayView<V> B);
+ *
+ * Summary:
+ *
+ *    Merge, union, difference and intersection of two views.
+ *
+ * Return Value: CustomArray result
+ *
+ * Description:
+ *
+ *   Functions that have friend privileges within the CustomArray class. Defined in CustomArrayView.h.
+ *   Return the same arrays as the overloads for arrays, without copying the viewed elements first.
+ *   Unsorted views are sorted in a temporary copy, as the set operations on arrays do.
+ *
+ */
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> merge(CustomArrayView<U> A, CustomArrayView<V> B);
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setUnion(CustomArrayView<U> A, CustomArrayView<V> B);
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setDifference(CustomArrayView<U> A, CustomArrayView<V> B);
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setIntersection(CustomArrayView<U> A, CustomArrayView<V> B);
 
 
 // Forward declaration of template friend functions ends here.
 
 
-template <typename T>
+template <typename T, typename Allocator>
 class CustomArray
 {
 private:
 
     std::size_t m_length{};
+    std::size_t m_capacity{};
+    std::size_t m_front{};
     T* m_array_ptr{};
+    Allocator m_allocator{};
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+
+    // The type of sum and dot. Sums of int arrays are accumulated in long long, so they do not overflow.
+    using SumType = typename SimdSumType<T>::type;
+
+private:
+    static_assert(std::is_same<typename AllocTraits::value_type, T>::value,
+                  "Allocator::value_type must be the same as the element type.");
+    static_assert(std::is_same<typename AllocTraits::pointer, T*>::value,
+                  "Allocator must allocate raw pointers.");
+
+    // Whether the elements are known to be in ascending order. Only ascending is relied upon, by search.
+    enum class SortState { unknown, ascending, unsorted };
+    mutable SortState m_sort_state{ SortState::ascending };
+
+    // Incremented by every member function that may change the elements, so that an index attached to the
+    // array, such as a CustomHashIndex, knows to rebuild. Not copied or swapped between arrays.
+    std::size_t m_revision{};
+
+    // The optional Bloom filter of the elements, and the revision it was last brought up to date with.
+    mutable std::unique_ptr<CustomBloomFilter<T>> m_bloom_ptr{};
+    mutable std::size_t m_bloom_revision{};
 
     // isNull is used primarily as a check for dynamic memory deletion within member functions.
     bool isNull() const { return m_array_ptr == nullptr; }
 
     /*
      *
-     * std::ostream& display(std::ostream& out) const;
+     * T* allocateBuffer(std::size_t capacity);
+     * void deallocateBuffer(T* buffer, std::size_t capacity);
      *
      * Summary:
      *
-     *   Sends the array data to the standard output.
+     *   Allocate and free memory for the array using m_allocator.
      *
-     * Parameters   : std::ostream& out
+     * Parameters   : T* buffer, std::size_t capacity
      *
-     * Return Value : std::ostream& out
+     * Return Value : T* buffer (allocateBuffer)
      *
      * Description:
      *
-     *   Prints each item in the array data to the terminal.
-     *   Called by the overloaded operator << friend function.
-     *   Contains specific overloads for a CustomArray<char> type.
-     *
-     * Example Output (default):
-     *   1 2 3
-     *
-     * Example Output (char)
-     *   abc
+     *   allocateBuffer allocates uninitialised memory for capacity elements. No element is constructed,
+     *   so reserving or growing the array does not construct elements that are not yet used.
+     *   deallocateBuffer deallocates a buffer from allocateBuffer. Its elements must already be destroyed.
+     *   capacity must be the same as when the buffer was allocated.
      *
      */
-    std::ostream& display(std::ostream& out) const;
+    T* allocateBuffer(std::size_t capacity);
+    void deallocateBuffer(T* buffer, std::size_t capacity);
 
     /*
      *
-     * void deepCopy(const CustomArray<T>& other);
+     * void constructCopies(const T* first, const T* last, T* destination);
+     * void constructMoves(T* first, T* last, T* destination);
+     * void constructValues(T* first, T* last);
+     * void destroyRange(T* first, T* last);
      *
      * Summary:
      *
-     *   Performs a deep copy of another array.
+     *   Construct and destroy elements in memory from allocateBuffer, using m_allocator.
      *
-     * Parameters   : CustomArray<T>& other
+     * Parameters   : T* first, T* last, T* destination
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Allocates a new portion of memory equal in size and structure to the other linked-list.
-     *   Copies the values of the other linked-list to the newly allocated memory.
-     *   Called by the CustomArray copy constructor and overloaded copy assignment member function.
+     *   constructCopies copy-constructs the elements [first, last) in the uninitialised memory at destination.
+     *   constructMoves move-constructs them using std::move_if_noexcept, so elements that may throw when
+     *   moved are copied instead, and the elements [first, last) are unchanged if an exception is thrown.
+     *   Trivially copyable elements are copied with a single std::memcpy by both functions.
+     *   constructValues value-initialises the elements in the uninitialised memory [first, last).
+     *   If an element throws, the elements already constructed are destroyed before the exception is rethrown.
+     *   destroyRange destroys the elements [first, last). Trivially destructible elements are left alone.
      *
      */
-    void deepCopy(const CustomArray<T>& other);
+    void constructCopies(const T* first, const T* last, T* destination);
+    void constructMoves(T* first, T* last, T* destination);
+    void constructValues(T* first, T* last);
+    void destroyRange(T* first, T* last);
+
+    // Returns the allocator for a new array made from this array, such as a copy or the result of a set operation.
+    Allocator selectAllocator() const { return AllocTraits::select_on_container_copy_construction(m_allocator); }
+
+    // Copy assignment and swaps only take the other allocator when the Allocator type propagates on them.
+    // std::pmr::polymorphic_allocator never propagates, so an array stays in its memory resource.
+    void propagateAllocator(const CustomArray<T, Allocator>& other, std::true_type) { m_allocator = other.m_allocator; }
+    void propagateAllocator(const CustomArray<T, Allocator>&, std::false_type) {}
+    void swapAllocator(CustomArray<T, Allocator>& other, std::true_type) { std::swap(m_allocator, other.m_allocator); }
+    void swapAllocator(CustomArray<T, Allocator>&, std::false_type) {}
+
+    // Swaps m_array_ptr, m_length, m_capacity, m_front and m_sort_state with other. m_allocator is not swapped.
+    void swapData(CustomArray<T, Allocator>& other);
 
     /*
      *
-     * bool linearSearch(const T& value);
+     * void recordInsert(int position, const T& value);
      *
      * Summary:
      *
-     *   Searches linearly for the specified value.
+     *   Updates m_sort_state before a value is inserted into the array.
      *
-     * Parameters   : const T& value
+     * Parameters   : int position, const T& value
      *
-     * Return Value : int index or -1.
+     * Return Value : None
      *
      * Description:
      *
-     *   Beginning at the first element in array, searches linearly for the specified value.
-     *   Returns either the element index of the first element that is equal to value, or -1.
+     *   If the array is in ascending order, compares value with the elements either side of position.
+     *   The array stays in ascending order if value fits between them. Else, the array becomes unsorted.
+     *   An unsorted array stays unsorted, as inserting a value cannot remove an existing pair out of order.
      *
      */
-    int linearSearch(const T& value);
+    void recordInsert(int position, const T& value);
+
+    // Removing elements keeps an ascending array in ascending order, but may put an unsorted array in order.
+    void recordErase() { advanceRevision(nullptr, 0); if (m_sort_state == SortState::unsorted) { m_sort_state = SortState::unknown; } }
 
     /*
      *
-     * int binarySearch(const T& value);
+     * void advanceRevision(const T* inserted, std::size_t count);
      *
      * Summary:
      *
-     *   Searches through a sorted array using the binary search algorithm.
+     *   Increments m_revision, keeping an up to date Bloom filter up to date.
      *
-     * Parameters   : const T& value
+     * Parameters   : const T* inserted, std::size_t count
      *
-     * Return Value : int index or -1.
+     * Return Value : None
      *
      * Description:
      *
-     *   Beginning at the first element in array, searches for the specified value using a binary search.
-     *   Returns either the element index of the first element that is equal to value, or -1.
+     *   Called when count values starting at inserted are added to the array, or when elements are removed.
+     *   A Bloom filter never gives a false negative for values that were removed, so if the filter was up to
+     *   date, adding the inserted values keeps it up to date, and search keeps using it without a rebuild.
+     *   Once the filter holds more values than it was sized for, it is left out of date, so the next search
+     *   rebuilds it at a size for the current length.
      *
      */
-    int binarySearch(const T& value);
+    void advanceRevision(const T* inserted, std::size_t count);
 
-public:
-
-    // An overloaded default constructor that writes a message to the standard output.
-    CustomArray() noexcept;
+    // Rebuilds the Bloom filter from the elements if it is out of date, sized for twice the current length.
+    void refreshBloom() const;
 
     /*
      *
-     * CustomArray(std::initializer_list<T> elements) noexcept;
+     * std::ostream& display(std::ostream& out) const;
      *
      * Summary:
      *
-     *   Initialises an array from a std::initializer_list.
+     *   Sends the array data to the standard output.
+     *
+     * Parameters   : std::ostream& out
      *
-     * Parameters: std::initializer_list<T> elements
+     * Return Value : std::ostream& out
      *
      * Description:
      *
-     *   Copies the values of a std::initializer_list to an array in heap memory.
-     *   Matches the length of the array to the length of the std::initializer_list.
+     *   Prints each item in the array data to the terminal.
+     *   Called by the overloaded operator << friend function.
+     *   Contains specific overloads for a CustomArray<char> type.
+     *
+     * Example Output (default):
+     *   1 2 3
+     *
+     * Example Output (char)
+     *   abc
      *
      */
-    CustomArray(std::initializer_list<T> elements) noexcept;
+    std::ostream& display(std::ostream& out) const;
 
     /*
      *
-     * CustomArray(const CustomArray<T>& other) noexcept;
+     * void deepCopy(const CustomArray<T, Allocator>& other);
      *
      * Summary:
      *
-     *   Initialises an array from another array.
+     *   Performs a deep copy of another array.
      *
-     * Parameters: CustomArray<T>& other
+     * Parameters   : CustomArray<T, Allocator>& other
+     *
+     * Return Value : None
      *
      * Description:
      *
-     *   Allocates a new portion of memory equal in size and structure to the other array.
-     *   Using deepCopy, copies the values of the other array to the newly allocated memory.
+     *   Allocates a new portion of memory equal in size and structure to the other linked-list.
+     *   Copy-constructs the values of the other linked-list in the newly allocated memory, using constructCopies.
+     *   Called by the CustomArray copy constructor and overloaded copy assignment member function.
      *
      */
-    CustomArray(const CustomArray<T>& other) noexcept;
+    void deepCopy(const CustomArray<T, Allocator>& other);
 
     /*
      *
-     * CustomArray(CustomArray<T>&& other) noexcept;
+     * void reallocate(std::size_t capacity, std::size_t front = 0);
      *
      * Summary:
      *
-     *   Initialises an array from another array, using move semantics.
+     *   Moves the array data into a new portion of heap memory of the specified capacity.
      *
-     * Parameters   : CustomLinkedList<T>&& other
+     * Parameters   : std::size_t capacity, std::size_t front
+     *
+     * Return Value : None
      *
      * Description:
      *
-     *   Switches the memory addreses of the linked-list and other linked-list pointers.
-     *   Sets the pointer addresses of the linked-list other to nullptr.
+     *   Allocates a new portion of memory that can hold capacity elements.
+     *   Moves the existing elements to the newly allocated memory, using constructMoves.
+     *   The first element is placed after front unused elements, so that pushFront can use them.
+     *   Destroys and deallocates the existing array and assigns the array pointer to the new array.
+     *   If an element throws while being copied, the array is unchanged.
+     *   Warning! Elements at a position greater than the new capacity will be dropped from the array.
      *
      */
-    CustomArray(CustomArray<T>&& other) noexcept;
+    void reallocate(std::size_t capacity, std::size_t front = 0);
 
     /*
      *
-     * template <typename InputIterator>
-     * CustomArray(InputIterator first, InputIterator last);
+     * std::size_t nextCapacity(std::size_t minimum) const;
      *
      * Summary:
      *
-     *   Initialises an array from another standard library container.
+     *   Returns the capacity to grow to when the allocated memory is full.
      *
-     * Parameters   : InputIterator first, InputIterator last
+     * Parameters   : std::size_t minimum
+     *
+     * Return Value : std::size_t capacity
      *
      * Description:
      *
-     *   Uses two iterators that are compatible with containers in the standard library.
-     *   Copies the data within a standard library container to the array.
+     *   Doubles the current capacity, or returns minimum if that is larger.
+     *   Geometric growth keeps the cost of pushBack amortised O(1).
      *
      */
-    template <typename InputIterator>
-    CustomArray(InputIterator first, InputIterator last) noexcept;
+    std::size_t nextCapacity(std::size_t minimum) const;
 
     /*
      *
-     * ~CustomArray() noexcept;
+     * void shiftData(std::size_t front);
      *
      * Summary:
      *
-     *   Frees each linked-list node in memory before destoying the linked-list.
+     *   Moves the array data within the allocated memory, leaving the specified number of unused elements before it.
+     *
+     * Parameters   : std::size_t front
+     *
+     * Return Value : None
      *
      * Description:
      *
-     *   Uses clear to erase all linked-list nodes before destroying the linked-list.
+     *   Moves each element to its new position using std::move, without allocating memory.
+     *   Trivially copyable elements are moved with a single std::memmove. Elements whose move constructor
+     *   may throw are moved by reallocate instead, so that the array is unchanged if one throws.
+     *   Used to reclaim the unused elements at one end of the allocated memory for the other end.
+     *   front must be no greater than the capacity minus the length of the array.
      *
      */
-    ~CustomArray() noexcept;
-
-    // Public member function declarations.
-    std::size_t size() const { return m_length; }
-    bool empty() const { return !m_length; }
+    void shiftData(std::size_t front);
 
     /*
      *
-     * void clear();
+     * void relocateRange(T* first, T* last, T* destination);
      *
      * Summary:
      *
-     *   Removes the array data from memory and the array.
+     *   Moves elements within the allocated memory, to a position that may overlap their current one.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, T* destination
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Removes the array data from the heap.
-     *   Sets the array pointer to nullptr.
-     *   Sets the array size to zero.
+     *   Move-constructs each element of [first, last) at destination and destroys the original, starting from
+     *   the end nearest to destination, so each element is moved into memory that is unused or whose element
+     *   has already been moved and destroyed. Trivially copyable elements are moved with a single std::memmove.
+     *   The memory at destination that is not overlapped by [first, last) must be uninitialised.
+     *   T must be trivially copyable or nothrow move constructible.
      *
      */
-    void clear();
+    void relocateRange(T* first, T* last, T* destination);
+
+    // Converts a position to an index no greater than the length, in the same way as insert. Supports negative indexing.
+    std::size_t clampPosition(int position) const;
+
+    // Updates m_sort_state after count values are inserted at position, by comparing the pairs of elements
+    // that include an inserted value. The array stays in ascending order if they are all in ascending order.
+    void recordInsertRange(std::size_t position, std::size_t count);
 
     /*
      *
-     * void resize(std::size_t length);
+     * template <typename Construct>
+     * void insertGap(std::size_t position, std::size_t count, Construct construct);
      *
      * Summary:
      *
-     *   Slow resize function. All elements are kept in the array up to the new length.
+     *   Inserts a number of elements at the specified position, constructed by a function.
      *
-     * Parameters   : int length
+     * Parameters   : std::size_t position, std::size_t count, Construct construct
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Creates a temporary array with the size specified length.
-     *   Copies elements from the existing array to the new temporary array
-     *   Deletes the existing array from memory and assigns the array pointer to the new arrary
-     *   Warning! Elements at a position greater than the new length will be dropped from the array.
+     *   If there is not enough unused memory after the array, allocates memory for at least the new length,
+     *   calls construct(destination) to construct the new elements there, then moves the existing elements
+     *   around them. Else, moves the elements after position count places to the right in a single pass,
+     *   and calls construct(destination) to construct the new elements in the gap. Elements that may throw
+     *   when moved are instead shifted by move-assignment, and the new elements are constructed in a scratch
+     *   buffer and moved into the gap.
+     *   So the array is shifted once and reallocated at most once, however many elements are inserted.
+     *   construct must construct count elements in the uninitialised memory at destination, destroying any
+     *   it has constructed before throwing. If it throws, the array is unchanged.
      *
      */
-    void resize(std::size_t length);
+    template <typename Construct>
+    void insertGap(std::size_t position, std::size_t count, Construct construct);
+
+    // Inserts [first, last) at position. Multi-pass iterators are counted and inserted with insertGap.
+    // Single pass iterators can only be read once, so their elements are read into a temporary array first.
+    template <typename ForwardIterator>
+    void insertRange(std::size_t position, ForwardIterator first, ForwardIterator last, std::true_type isMultiPass);
+    template <typename InputIterator>
+    void insertRange(std::size_t position, InputIterator first, InputIterator last, std::false_type isMultiPass);
+
+    // Construct count elements in uninitialised memory at destination, from the elements starting at first
+    // (constructFrom) or as copies of value (constructFill). If an element throws, the elements already
+    // constructed are destroyed before the exception is rethrown.
+    template <typename ForwardIterator>
+    void constructFrom(ForwardIterator first, std::size_t count, T* destination);
+    void constructFill(T* destination, std::size_t count, const T& value);
+
+    // Returns std::true_type if the std::iterator_traits category of Iterator is at least a forward iterator.
+    template <typename Iterator>
+    static auto isMultiPass(int) -> std::is_base_of<std::forward_iterator_tag,
+                                                    typename std::iterator_traits<Iterator>::iterator_category>;
+    template <typename Iterator>
+    static std::false_type isMultiPass(...);
 
     /*
      *
-     * void insert(int position, const T& value);
+     * bool linearSearch(const T& value);
      *
      * Summary:
      *
-     *   Inserts data into the array at the specified position.
+     *   Searches linearly for the specified value.
      *
-     * Parameters   : int position, const T& value
+     * Parameters   : const T& value
      *
-     * Return Value : None
+     * Return Value : int index or -1.
      *
      * Description:
      *
-     *   Creates a new temporary array in the heap.
-     *   Copies values from the array to the new temporary array, with the additional value.
-     *   Deletes the existing array from heap memory.
-     *   Points the CustomArray pointer to the newly created temporary array.
-     *   Increments the length by one.
-     *   Support negative indexing!
+     *   Beginning at the first element in array, searches linearly for the specified value.
+     *   Returns either the element index of the first element that is equal to value, or -1.
+     *   Uses simdFind, which compares 2 to 32 elements per instruction for int, float, double and char arrays.
      *
      */
-    void insert(int position, const T& value);
+    int linearSearch(const T& value);
 
     /*
      *
-     * void erase(int position);
+     * int binarySearch(const T& value);
      *
      * Summary:
      *
-     *   Removes data from the array at the specified position.
+     *   Searches through a sorted array using the binary search algorithm.
      *
-     * Parameters   : int position
+     * Parameters   : const T& value
      *
-     * Return Value : None
+     * Return Value : int index or -1.
      *
      * Description:
      *
-     *   Creates a new temporary array in the heap.
-     *   Copies values from the array to the new temporary array, except data at the specified position.
-     *   Deletes the existing array from heap memory.
-     *   Points the CustomArray to the newly created temporary array.
-     *   Decrements the length by one.
-     *   Support negative indexing!
+     *   Finds the first element that is not less than value using branchlessBound, then checks it equals value.
+     *   Returns either the element index of the first element that is equal to value, or -1.
      *
      */
-    void erase(int position);
+    int binarySearch(const T& value);
 
     /*
      *
-     * void pushBack(const T& value);
+     * template <typename Before>
+     * static std::size_t branchlessBound(const T* data, std::size_t length, Before before);
      *
      * Summary:
      *
-     *   Appends a new value to the end of the array.
+     *   Returns the number of leading elements of a sorted range for which a predicate is true.
      *
-     * Parameters   : const T& value
+     * Parameters   : const T* data, std::size_t length, Before before
      *
-     * Return Value : None
+     * Return Value : std::size_t index
      *
      * Description:
      *
-     *   Calls the insert function with position equal to the current length of the array.
+     *   before must be true for a prefix of [data, data + length) and false for the rest. Each step halves the
+     *   range and moves its base with a conditional move instead of a branch, so the loop runs exactly
+     *   log2(length) times whatever the data, and no step waits on a mispredicted comparison. Both midpoints the
+     *   next step could probe are prefetched, so the load it makes has already been requested.
      *
      */
-    void pushBack(const T& value);
+    template <typename Before>
+    static std::size_t branchlessBound(const T* data, std::size_t length, Before before);
 
     /*
      *
-     * void pushFront(const T& value);
+     * static void interleavedLowerBounds(const T* data, std::size_t length,
+     *                                    const T* keys, std::size_t count, std::size_t* bounds);
      *
      * Summary:
      *
-     *   Inserts a new value at the start of the array.
+     *   Finds the lower bound of each of several keys in a sorted range.
      *
-     * Parameters   : const T& value
+     * Parameters   : const T* data, std::size_t length, const T* keys, std::size_t count, std::size_t* bounds
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Calls the insert function with position equal to zero.
+     *   Writes the index of the first element that is not less than keys[i] to bounds[i].
+     *   Searches searchManyLanes keys at once, taking one step of each search in turn. The searches do not
+     *   depend on each other, so the processor overlaps their cache misses instead of waiting for each in turn.
      *
      */
-    void pushFront(const T& value);
+    static void interleavedLowerBounds(const T* data, std::size_t length,
+                                       const T* keys, std::size_t count, std::size_t* bounds);
+
+    // The number of searches interleavedLowerBounds runs at once.
+    static constexpr std::size_t searchManyLanes{ 8 };
+
+    // Tuning constants for pdqSort. Ranges smaller than insertionSortThreshold are insertion sorted,
+    // and ranges larger than nintherThreshold use Tukey's ninther to select the pivot.
+    static constexpr std::ptrdiff_t insertionSortThreshold{ 24 };
+    static constexpr std::ptrdiff_t nintherThreshold{ 128 };
+    static constexpr std::size_t partialInsertionSortLimit{ 8 };
 
     /*
      *
-     * void popBack();
+     * template <typename Compare>
+     * static void pdqSort(T* first, T* last, Compare comp, int badAllowed, bool leftmost);
      *
      * Summary:
      *
-     *   Removes an existing value from the end of the array.
+     *   Sorts a range of elements using the pattern-defeating quicksort algorithm.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, Compare comp, int badAllowed, bool leftmost
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Calls the erase function with position equal to the current length of the array.
+     *   Sorts the range [first, last) so that comp is false for every element and the element before it.
+     *   Selects a pivot using the median of three elements, or Tukey's ninther for large ranges.
+     *   If leftmost is false, the element before first is no greater than any element of the range.
+     *   When that element equals the pivot, equal elements are partitioned left and skipped.
+     *   Ranges that were already partitioned are finished with partialInsertionSort, so sorted input is O(n).
+     *   Each highly unbalanced partition breaks up patterns by swapping elements, and decrements badAllowed.
+     *   When badAllowed reaches zero the range is sorted with heapSort, guaranteeing O(n log n).
+     *   Small ranges are sorted with insertionSort.
      *
      */
-    void popBack();
+    template <typename Compare>
+    static void pdqSort(T* first, T* last, Compare comp, int badAllowed, bool leftmost);
 
     /*
      *
-     * void popFront();
+     * template <typename Compare>
+     * static std::pair<T*, bool> partitionRight(T* first, T* last, Compare comp);
      *
      * Summary:
      *
-     *   Removes an existing value from the start of the array.
+     *   Partitions a range around its first element, placing equal elements to the right.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, Compare comp
      *
-     * Return Value : None
+     * Return Value : std::pair<T*, bool> { pivot position, already partitioned }
      *
      * Description:
      *
-     *   Calls the erase function with position equal to zero.
+     *   Uses *first as the pivot. Elements less than the pivot are moved before the returned position,
+     *   and all other elements after it. The pivot is moved to the returned position.
+     *   The second value is true if no elements had to be swapped.
+     *   Requires an element no less than the pivot in the range, which the pivot selection guarantees.
      *
      */
-    void popFront();
+    template <typename Compare>
+    static std::pair<T*, bool> partitionRight(T* first, T* last, Compare comp);
 
     /*
      *
-     * void reverse();
+     * template <typename Compare>
+     * static T* partitionLeft(T* first, T* last, Compare comp);
      *
      * Summary:
      *
-     *   Reverses the order of the array elements in place.
+     *   Partitions a range around its first element, placing equal elements to the left.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, Compare comp
      *
-     * Return Value : None
+     * Return Value : T* pivot position
      *
      * Description:
      *
-     *   Iterates forwards and backwards through the array (from the start and end).
-     *   Each iteration, the iterator values are swapped using std::swap.
-     *   This results in a permanent change to the array.
+     *   Uses *first as the pivot. Elements greater than the pivot are moved after the returned position,
+     *   and all other elements before it. The pivot is moved to the returned position.
+     *   Used when many elements equal the pivot, as those elements need no further sorting.
      *
      */
-    void reverse();
+    template <typename Compare>
+    static T* partitionLeft(T* first, T* last, Compare comp);
 
     /*
      *
-     * void bubbleSort();
+     * template <typename Compare>
+     * static void insertionSort(T* first, T* last, Compare comp, bool leftmost);
      *
      * Summary:
      *
-     *   Sorts the array in ascending order using the bubblesort algorithm.
+     *   Sorts a small range of elements using the insertion sort algorithm.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, Compare comp, bool leftmost
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Sorts the array in ascending order using the bubblesort algorithm.
-     *   This results in a permanent change to the array.
+     *   Moves each element left until it is no less than the element before it.
+     *   If leftmost is false, the element before first is used as a sentinel and the bounds check is skipped.
      *
      */
-    void bubbleSort();
+    template <typename Compare>
+    static void insertionSort(T* first, T* last, Compare comp, bool leftmost);
 
     /*
      *
-     * bool isSorted();
+     * template <typename Compare>
+     * static bool partialInsertionSort(T* first, T* last, Compare comp);
      *
      * Summary:
      *
-     *   Function to state whether the array elements are in ascending order or not.
+     *   Attempts an insertion sort of a range, giving up if too many elements are out of place.
      *
-     * Parameters   : None
+     * Parameters   : T* first, T* last, Compare comp
      *
-     * Return Value : None
+     * Return Value : bool True if the range was sorted. Else, returns False.
      *
      * Description:
      *
-     *   Iterates through the array.
-     *   Returns false if an element is found to be larger than the next element to the right.
-     *   Elements are considered sorted if they are in ascending order.
+     *   Performs an insertion sort, counting the number of element moves.
+     *   Returns false as soon as more than partialInsertionSortLimit elements have been moved.
      *
      */
-    bool isSorted();
+    template <typename Compare>
+    static bool partialInsertionSort(T* first, T* last, Compare comp);
 
     /*
      *
-     * int search(const T& value);
+     * template <typename Compare>
+     * static void heapSort(T* first, T* last, Compare comp);
      *
      * Summary:
      *
-     *   Searches the array for a specified value.
+     *   Sorts a range of elements using the heapsort algorithm.
      *
-     * Parameters   : const T& value
+     * Parameters   : T* first, T* last, Compare comp
      *
-     * Return Value : int index or -1.
+     * Return Value : None
      *
      * Description:
      *
-     *   Identifies whether the array is sorted or not, using isSorted().
-     *   If the array is sorted, performs a binary search using binarySearch().
-     *   If the array isn't sorted, performs a linear search using linearSearch().
-     *   Returns either the index position of the elements that matches value, or -1.
+     *   Builds a max heap in place, then repeatedly moves the largest element to the end of the range.
+     *   O(n log n) for every input. Used by pdqSort when too many partitions are unbalanced.
      *
      */
-    int search(const T& value);
+    template <typename Compare>
+    static void heapSort(T* first, T* last, Compare comp);
 
     /*
      *
-     * void swap(CustomArray<T>& other);
+     * template <typename Compare>
+     * static void sort3(T* a, T* b, T* c, Compare comp);
      *
      * Summary:
      *
-     *   Swaps array data nodes with another array.
+     *   Sorts three elements in place.
      *
-     * Parameters   : CustomArray<T>& other
+     * Parameters   : T* a, T* b, T* c, Compare comp
      *
      * Return Value : None
      *
      * Description:
      *
-     *   Switches the m_array_ptr of the array with other.
+     *   Swaps the elements so that *a, *b and *c are in order. Leaves the median of the three in *b.
      *
      */
-    void swap(CustomArray<T>& other);
+    template <typename Compare>
+    static void sort3(T* a, T* b, T* c, Compare comp);
+
+    // Arrays shorter than radixSortThreshold are sorted with sort, as the radix passes cost more than they save.
+    static constexpr std::size_t radixSortThreshold{ 256 };
+
+    // An unsigned integer type the same size as T, used as the radix sort key.
+    using RadixKey = typename std::conditional<sizeof(T) == 1, std::uint8_t,
+                     typename std::conditional<sizeof(T) == 2, std::uint16_t,
+                     typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type>::type>::type;
 
     /*
      *
-     * T& operator[](int position);
+     * static RadixKey radixKey(const T& value);
      *
      * Summary:
      *
-     *   Index operator overload.
+     *   Maps an arithmetic element to an unsigned integer with the same ordering.
      *
-     * Return Value: T& m_array_ptr[position]
+     * Parameters   : const T& value
+     *
+     * Return Value : RadixKey key
      *
      * Description:
      *
-     *   Returns the element of the array at the specified position.
-     *   Support negative indexing!
+     *   Copies the bits of value into an unsigned integer of the same size.
+     *   Signed integers have their sign bit flipped, so negative values order before positive values.
+     *   IEEE floating point numbers have every bit flipped if negative, or only the sign bit if positive,
+     *   so that negative values order by decreasing magnitude before positive values.
+     *   -0.0 orders before +0.0. NaN values order by their sign, before or after every other value.
      *
      */
-    T& operator[](int position);
+    static RadixKey radixKey(const T& value);
+    static RadixKey radixKey(const T& value, std::true_type isFloatingPoint);
+    static RadixKey radixKey(const T& value, std::false_type isFloatingPoint);
+
+    // parallelSort gives each thread at least parallelSortGrain elements, as smaller chunks cost more to start than to sort.
+    static constexpr std::size_t parallelSortGrain{ 1 << 15 };
+
+    // The reductions do little work per element, so each thread is given at least parallelReduceGrain elements.
+    static constexpr std::size_t parallelReduceGrain{ 1 << 18 };
 
     /*
      *
-     * T& operator[](int position);
+     * template <typename Compare>
+     * static const T* rangeLowerBound(const T* first, const T* last, const T& value, Compare comp);
      *
      * Summary:
      *
-     *   Index operator overload.
+     *   Returns the first element of a sorted range that is not less than a value.
      *
-     * Return Value: const T& m_array_ptr[position]
+     * Parameters   : const T* first, const T* last, const T& value, Compare comp
+     *
+     * Return Value : const T* position
      *
      * Description:
      *
-     *   Returns the element of the array at the specified position.
-     *   Support negative indexing!
+     *   Performs a binary search of the range [first, last), which must be sorted by comp.
+     *   Returns last if every element is less than value.
      *
      */
-    const T& operator[](int position) const;
+    template <typename Compare>
+    static const T* rangeLowerBound(const T* first, const T* last, const T& value, Compare comp);
 
     /*
      *
-     * CustomArray& operator=(const CustomArray<T>& other);
+     * template <typename Compare>
+     * static const T* rangeUpperBound(const T* first, const T* last, const T& value, Compare comp);
      *
      * Summary:
      *
-     *   Copy assignment operator overload.
+     *   Returns the first element of a sorted range that is greater than a value.
      *
-     * Return Value: *this
+     * Parameters   : const T* first, const T* last, const T& value, Compare comp
+     *
+     * Return Value : const T* position
      *
      * Description:
      *
-     *   Clears the existing array.
-     *   Allocates a new portion of memory equal in size and structure to the array other.
-     *   Using deepCopy, copies the values of the other linked-list to the newly allocated memory.
+     *   Performs a binary search of the range [first, last), which must be sorted by comp.
+     *   Returns last if no element is greater than value.
      *
      */
-    CustomArray& operator=(const CustomArray<T>& other);
+    template <typename Compare>
+    static const T* rangeUpperBound(const T* first, const T* last, const T& value, Compare comp);
+
+    // The set operations switch to gallopLowerBound when one array is at least gallopRatio times longer than the other.
+    static constexpr std::size_t gallopRatio{ 16 };
 
     /*
      *
-     * CustomArray& operator=(CustomArray<T>&& other);
+     * template <typename Compare>
+     * static const T* gallopLowerBound(const T* first, const T* last, const T& value, Compare comp);
      *
      * Summary:
      *
-     *   Move assignment operator overload.
+     *   Returns the first element of a sorted range that is not less than a value, searching from the start.
      *
-     * Return Value: *this
+     * Parameters   : const T* first, const T* last, const T& value, Compare comp
+     *
+     * Return Value : const T* position
      *
      * Description:
      *
-     *   Switches array pointer addresses and lengths with the temporary/anonymous array object other.
+     *   Performs an exponential (galloping) search: compares the elements 1, 2, 4, 8... places after first
+     *   until one is not less than value, then binary searches the last gap using rangeLowerBound.
+     *   O(log d) comparisons, where d is the distance from first to the result, rather than O(log n).
+     *   Returns last if every element is less than value.
      *
      */
-    CustomArray& operator=(CustomArray<T>&& other);
+    template <typename Compare>
+    static const T* gallopLowerBound(const T* first, const T* last, const T& value, Compare comp);
 
     /*
      *
-     * CustomArray& operator=(std::initializer_list<T> elements);
+     * static const CustomArray<T, Allocator>& sortedOrCopy(const CustomArray<T, Allocator>& array, CustomArray<T, Allocator>& copy,
+     *                                           std::size_t threads = 1);
      *
      * Summary:
      *
-     *   Copy assignment operator overload from a std::initializer_list.
+     *   Returns an array if it is sorted, or a sorted copy of it.
      *
-     * Return Value: *this
+     * Parameters   : const CustomArray<T, Allocator>& array, CustomArray<T, Allocator>& copy, std::size_t threads
+     *
+     * Return Value : const CustomArray<T, Allocator>& sorted
      *
      * Description:
      *
-     *   Uses the copy and swap idiom.
-     *   Creates a temporary array with the std::initializer_list elements.
-     *   Switches pointer addresses and lengths with the temporary array.
+     *   If array is in ascending order, returns array without copying it.
+     *   Else, copies array into copy, sorts copy using sort (or parallelSort if threads is not one), and returns copy.
+     *   Used by the set operations, which take their arrays by const reference.
      *
      */
-    CustomArray& operator=(std::initializer_list<T> elements);
-
-    // Fully specialised template friend function declarations.
-    friend std::ostream& operator<<<T>(std::ostream& out, const CustomArray<T>& arr);
-    friend CustomArray<T> merge<T>(const CustomArray<T>& A, const CustomArray<T>& B);
-    friend CustomArray<T> setUnion<T>(CustomArray<T> A, CustomArray<T> B);
-    friend CustomArray<T> setDifference<T>(CustomArray<T> A, CustomArray<T> B);
-    friend CustomArray<T> setIntersection<T>(CustomArray<T> A, CustomArray<T> B);
+    static const CustomArray<T, Allocator>& sortedOrCopy(const CustomArray<T, Allocator>& array, CustomArray<T, Allocator>& copy,
+                                              std::size_t threads = 1);
 
     /*
      *
-     *   Class Name: Iterator
+     * template <typename Compare>
+     * static void multiwaySplit(T* data, const std::size_t* bounds, std::size_t ways,
+     *                           std::size_t rank, std::size_t* positions, Compare comp);
      *
-     *   Purpose:
-     *     A bidirectional non-const iterator for CustomArray<T> objects.
+     * Summary:
+     *
+     *   Finds where the element of a given rank splits each of several sorted ranges.
+     *
+     * Parameters   : T* data, const std::size_t* bounds, std::size_t ways, std::size_t rank,
+     *                std::size_t* positions, Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Range i is [data + bounds[i], data + bounds[i + 1]), and is sorted by comp.
+     *   Writes positions[i] for each range, such that the positions sum to rank and every element before
+     *   a position is no greater than every element after any position.
+     *   Finds the element of the given rank with a binary search of each range, then takes the elements
+     *   equal to it from the ranges in order. O(ways^2 log^2 n).
+     *   Positions for a larger rank are never less than positions for a smaller rank.
      *
      */
-    class Iterator
-    {
-        using iterator_category = std::bidirectional_iterator_tag;
-        using value_type = T;
-        using difference_type = std::ptrdiff_t;
-        using pointer = T*;
-        using reference = T&;
-    private:
-        pointer m_ptr;
-    public:
-        Iterator(pointer ptr = nullptr) : m_ptr{ ptr } {}
-        Iterator(const Iterator& other) : m_ptr{ other.m_ptr } {}
-        reference operator*() const { return *m_ptr; }
-        pointer operator->() const { return m_ptr; }
-        Iterator& operator++() { ++m_ptr; return *this; }
-        Iterator operator++(int) { Iterator tmp{ *this }; ++(*this); return tmp; }
-        Iterator& operator--() { --m_ptr; return *this; }
-        Iterator operator--(int) { Iterator tmp{ *this }; --(*this); return tmp; }
-        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_ptr == b.m_ptr; }
-        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_ptr != b.m_ptr; }
-    };
-
-    Iterator begin() { return Iterator{ m_array_ptr }; }
-    Iterator end() { return Iterator{ m_array_ptr + m_length }; }
+    template <typename Compare>
+    static void multiwaySplit(T* data, const std::size_t* bounds, std::size_t ways,
+                              std::size_t rank, std::size_t* positions, Compare comp);
 
     /*
      *
-     *   Class Name: ConstIterator
+     * template <typename Compare>
+     * static void multiwayMerge(T** heads, T** tails, std::size_t ways, T* out, Compare comp);
      *
-     *   Purpose:
-     *     A bidirectional const iterator for const CustomArray<T> objects.
+     * Summary:
+     *
+     *   Merges several sorted ranges into one.
+     *
+     * Parameters   : T** heads, T** tails, std::size_t ways, T* out, Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Range i is [heads[i], tails[i]), and is sorted by comp.
+     *   Keeps the ranges in a binary heap ordered by their first element, and repeatedly moves the
+     *   smallest first element to out. O(n log ways). heads and tails are modified.
      *
      */
-    class ConstIterator
-    {
-        using iterator_category = std::bidirectional_iterator_tag;
-        using value_type = T;
-        using difference_type = std::ptrdiff_t;
-        using pointer = const T*;
-        using reference = const T&;
-    private:
-        pointer m_ptr;
-    public:
-        ConstIterator(pointer ptr = nullptr) : m_ptr{ ptr } {}
-        ConstIterator(const ConstIterator& other) : m_ptr{ other.m_ptr } {}
-        reference operator*() const { return *m_ptr; }
-        pointer operator->() const { return m_ptr; }
-        ConstIterator& operator++() { ++m_ptr; return *this; }
-        ConstIterator operator++(int) { ConstIterator tmp{ *this }; ++(*this); return tmp; }
-        ConstIterator& operator--() { --m_ptr; return *this; }
-        ConstIterator operator--(int) { ConstIterator tmp{ *this }; --(*this); return tmp; }
-        friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.m_ptr == b.m_ptr; }
-        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.m_ptr != b.m_ptr; }
-    };
+    template <typename Compare>
+    static void multiwayMerge(T** heads, T** tails, std::size_t ways, T* out, Compare comp);
 
-    ConstIterator begin() const { return ConstIterator{ m_array_ptr }; }
-    ConstIterator end() const { return ConstIterator{ m_array_ptr + m_length }; }
+    /*
+     *
+     * template <typename Function>
+     * static void runParallel(std::size_t threads, Function function);
+     *
+     * Summary:
+     *
+     *   Calls a function once per thread index, on separate threads.
+     *
+     * Parameters   : std::size_t threads, Function function
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls function(index) for each index in [0, threads). Index zero runs on the calling thread.
+     *   Returns once every call has finished.
+     *   If a thread cannot be started, its index is run on the calling thread instead.
+     *   If any call throws, the exception of the lowest such index is rethrown after every thread has been joined.
+     *
+     */
+    template <typename Function>
+    static void runParallel(std::size_t threads, Function function);
 
-};
+    // Returns threads, or std::thread::hardware_concurrency() if threads is zero, reduced so that each
+    // thread has at least grain of the elements. Never less than one.
+    static std::size_t parallelThreads(std::size_t threads, std::size_t elements, std::size_t grain = parallelSortGrain);
 
+    // Splits length elements into threads contiguous chunks of nearly equal size, and calls
+    // function(chunk, first, last) for each chunk [first, last) using runParallel.
+    template <typename Function>
+    static void parallelChunks(std::size_t length, std::size_t threads, Function function);
 
-// Private member function definitions begin here.
+    /*
+     *
+     * static std::size_t mergePathSplit(T* a, std::size_t aLength, T* b, std::size_t bLength, std::size_t diagonal);
+     *
+     * Summary:
+     *
+     *   Returns how many elements of one sorted range are among the first elements of a merge with another.
+     *
+     * Parameters   : T* a, std::size_t aLength, T* b, std::size_t bLength, std::size_t diagonal
+     *
+     * Return Value : std::size_t count
+     *
+     * Description:
+     *
+     *   The merge path of two sorted ranges is the order in which a merge takes their elements.
+     *   Returns the number of elements of a among the first diagonal elements taken, when elements of b are
+     *   taken first if equal (as merge does). The remaining diagonal - count elements are taken from b.
+     *   Binary searches the diagonal. O(log n).
+     *
+     */
+    static std::size_t mergePathSplit(T* a, std::size_t aLength, T* b, std::size_t bLength, std::size_t diagonal);
 
-template<typename T>
-std::ostream& CustomArray<T>::display(std::ostream& out) const
-{
-    auto it{ begin() };
-    T* last{ m_array_ptr + m_length - 1 };
-    if (m_length)
+    // Output objects for the range functions below. PointerOutput constructs each element in place in
+    // consecutive uninitialised memory, and CountingOutput only counts them, so the same function can measure
+    // and then write its output. ArrayOutput appends each element to an array, for the single threaded merge.
+    struct PointerOutput
     {
-        do
-        {
-            if (it == last)
-            {
-                out << *it;
-            }
-            else
-            {
-                out << *it << " ";
-            }
-        }
-        while (++it != end());
-    }
-    return out;
-}
+        Allocator m_allocator;
+        T* m_ptr;
+        void put(const T& value) { AllocTraits::construct(m_allocator, m_ptr, value); ++m_ptr; }
+    };
 
-template<>
-std::ostream& CustomArray<char>::display(std::ostream& out) const
-{
-    for (auto it{begin()}; it != end(); ++it)
+    struct CountingOutput
     {
-        out << *it;
-    }
-    return out;
-}
+        std::size_t m_count;
+        void put(const T&) { ++m_count; }
+    };
 
-template<typename T>
-void CustomArray<T>::deepCopy(const CustomArray<T> &other)
-{
-    if (other.m_length > 0)
+    struct ArrayOutput
     {
-        m_length = other.m_length;
-        m_array_ptr = new T[m_length];
-        for (int idx{ 0 }; idx < static_cast<int>(m_length); ++idx)
-        {
-            m_array_ptr[idx] = other.m_array_ptr[idx];
-        }
-    }
-}
+        CustomArray<T, Allocator>& m_array;
+        void put(const T& value) { m_array.pushBack(value); }
+    };
 
-template <typename T>
-int CustomArray<T>::linearSearch(const T& value)
-{
-    for (int index{ 0 }; index < static_cast<int>(m_length); ++index)
-    {
-        if (value == m_array_ptr[index])
-        {
-            return index;
-        }
-    }
-    return -1;
-}
+    /*
+     *
+     * template <typename Output>
+     * static void mergeRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+     * static void unionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+     * static void differenceRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+     * static void intersectionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+     *
+     * Summary:
+     *
+     *   Perform a merge or set operation on two sorted ranges, passing each output element to an output object.
+     *
+     * Parameters   : const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Walk the ranges [i, iEnd) and [j, jEnd) in step, as merge, setUnion, setDifference and setIntersection do,
+     *   and call out.put for each element of the result.
+     *
+     */
+    template <typename Output>
+    static void mergeRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+    template <typename Output>
+    static void unionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+    template <typename Output>
+    static void differenceRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
+    template <typename Output>
+    static void intersectionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out);
 
-template <typename T>
-int CustomArray<T>::binarySearch(const T& value)
-{
-    assert(isSorted() && "Array elements must be in ascending order.");
-    int index{};
-    int low{};
-    int high{ static_cast<int>(m_length) - 1 };
-    while (low <= high)
+    // Function objects that pass their arguments on to the set operation range functions, so that
+    // parallelSetOperation can call the same operation with either output object.
+    struct UnionOperation
     {
-        index = (low + high ) / 2;
-        if (value == m_array_ptr[index])
-        {
-            return index;
-        }
-        else if (value < m_array_ptr[index])
-        {
-            high = index - 1;
-        }
-        else
-        {
-            low = index + 1;
-        }
-    }
-    return -1;
-}
-
-// Private member function definitions end here.
-
-// Constructor and Destructor definitions begin here.
+        template <typename Output>
+        void operator()(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out) const { unionRanges(i, iEnd, j, jEnd, out); }
+    };
 
-template <typename T>
-CustomArray<T>::CustomArray() noexcept
-{
-    std::cout << "CustomArray default constructor called.\n";
-}
+    struct DifferenceOperation
+    {
+        template <typename Output>
+        void operator()(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out) const { differenceRanges(i, iEnd, j, jEnd, out); }
+    };
 
-template <typename T>
-CustomArray<T>::CustomArray(std::initializer_list<T> elements) noexcept
-{
-    std::cout << "CustomArray list-initialised constructor called.\n" ;
-    if (elements.size() > 0)
+    struct IntersectionOperation
     {
-        m_length = elements.size();
-        m_array_ptr = new T[elements.size()];
-        int counter{ 0 };
-        for (auto element : elements)
-        {
-            m_array_ptr[counter++] = element;
-        }
-    }
-}
+        template <typename Output>
+        void operator()(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out) const { intersectionRanges(i, iEnd, j, jEnd, out); }
+    };
 
-template <typename T>
-CustomArray<T>::CustomArray(const CustomArray<T>& other) noexcept
-{
-    std::cout << "CustomArray copy constructor called.\n";
-    deepCopy(other);
-}
+    /*
+     *
+     * static void unionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+     * static void differenceSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+     * static void intersectionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+     *
+     * Summary:
+     *
+     *   Append the union, difference or intersection of two sorted ranges to an array.
+     *
+     * Parameters   : const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   The single threaded engine of setUnion, setDifference and setIntersection, for both arrays and views.
+     *   If one range is at least gallopRatio times longer than the other, walks the shorter range and finds
+     *   each of its elements in the longer one with gallopLowerBound. Else, walks both ranges in step.
+     *
+     */
+    static void unionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+    static void differenceSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+    static void intersectionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result);
+
+    /*
+     *
+     * template <typename Operation>
+     * static CustomArray<T, Allocator> parallelSetOperation(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B,
+     *                                            std::size_t threads, Operation operation);
+     *
+     * Summary:
+     *
+     *   Performs a set operation on two arrays using multiple threads.
+     *
+     * Parameters   : const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads, Operation operation
+     *
+     * Return Value : CustomArray result
+     *
+     * Description:
+     *
+     *   Splits the merge path of A and B into one equal part per thread using mergePathSplit.
+     *   Each split is moved back to the first element equal to the next element on the path, so equal
+     *   elements of A and B are never separated, and every pair of ranges can be processed independently.
+     *   Each thread calls operation with a CountingOutput to size its part of the result. After the parts
+     *   are summed, the result is built by parallelConstruct, with each thread calling operation again.
+     *
+     */
+    template <typename Operation>
+    static CustomArray<T, Allocator> parallelSetOperation(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B,
+                                               std::size_t threads, Operation operation);
+
+    /*
+     *
+     * template <typename Function>
+     * static CustomArray<T, Allocator> parallelConstruct(const Allocator& allocator, const std::size_t* offsets,
+     *                                                    std::size_t threads, Function function);
+     *
+     * Summary:
+     *
+     *   Builds an array whose parts are constructed by separate threads.
+     *
+     * Parameters   : const Allocator& allocator, const std::size_t* offsets, std::size_t threads, Function function
+     *
+     * Return Value : CustomArray result
+     *
+     * Description:
+     *
+     *   Part t of the result is [offsets[t], offsets[t + 1]), and offsets[threads] is its length.
+     *   The buffer is allocated once, and each thread calls function(part, writer) with a PointerOutput that
+     *   constructs exactly the elements of its part in place. If any part throws, the elements constructed by
+     *   every part are destroyed and the buffer is released before the exception is rethrown.
+     *   Throws std::bad_alloc if the buffer cannot be allocated.
+     *
+     */
+    template <typename Function>
+    static CustomArray<T, Allocator> parallelConstruct(const Allocator& allocator, const std::size_t* offsets,
+                                                       std::size_t threads, Function function);
+
+    /*
+     *
+     * static SumType sumRange(const T* data, std::size_t length, std::size_t threads);
+     * static SumType dotRange(const T* a, const T* b, std::size_t length, std::size_t threads);
+     * static std::pair<T, T> minMaxRange(const T* data, std::size_t length, std::size_t threads);
+     * static void fillRange(T* data, std::size_t length, const T& value, std::size_t threads);
+     * template <typename Function>
+     * static void transformRange(T* data, std::size_t length, Function function, std::size_t threads);
+     *
+     * Summary:
+     *
+     *   The engines of sum, dot, minMax, fill and transform, for both arrays and views.
+     *
+     * Parameters   : const T* data, std::size_t length, std::size_t threads
+     *
+     * Return Value : The sum, dot product or least and greatest elements of the range.
+     *
+     * Description:
+     *
+     *   Run the simdSum, simdDot, simdMinMax, simdFill or simdTransform kernel on the range.
+     *   If threads is not one, the range is split with parallelChunks into one chunk per thread, with at least
+     *   parallelReduceGrain elements each, and the partial results are combined in chunk order.
+     *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+     *
+     */
+    static SumType sumRange(const T* data, std::size_t length, std::size_t threads);
+    static SumType dotRange(const T* a, const T* b, std::size_t length, std::size_t threads);
+    static std::pair<T, T> minMaxRange(const T* data, std::size_t length, std::size_t threads);
+    static void fillRange(T* data, std::size_t length, const T& value, std::size_t threads);
+    template <typename Function>
+    static void transformRange(T* data, std::size_t length, Function function, std::size_t threads);
+
+public:
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomArray() noexcept;
+
+    // Initialises an empty array that allocates its memory with allocator.
+    explicit CustomArray(const Allocator& allocator) noexcept;
+
+    /*
+     *
+     * CustomArray(std::initializer_list<T> elements, const Allocator& allocator = Allocator{}) noexcept;
+     *
+     * Summary:
+     *
+     *   Initialises an array from a std::initializer_list.
+     *
+     * Parameters: std::initializer_list<T> elements, const Allocator& allocator
+     *
+     * Description:
+     *
+     *   Copies the values of a std::initializer_list to an array in heap memory.
+     *   Matches the length of the array to the length of the std::initializer_list.
+     *
+     */
+    CustomArray(std::initializer_list<T> elements, const Allocator& allocator = Allocator{}) noexcept;
+
+    /*
+     *
+     * CustomArray(const CustomArray<T, Allocator>& other) noexcept;
+     *
+     * Summary:
+     *
+     *   Initialises an array from another array.
+     *
+     * Parameters: CustomArray<T, Allocator>& other
+     *
+     * Description:
+     *
+     *   Allocates a new portion of memory equal in size and structure to the other array.
+     *   Using deepCopy, copies the values of the other array to the newly allocated memory.
+     *   The allocator is chosen by std::allocator_traits<Allocator>::select_on_container_copy_construction.
+     *
+     */
+    CustomArray(const CustomArray<T, Allocator>& other) noexcept;
+
+    // Initialises an array from another array, allocating the copy with allocator.
+    CustomArray(const CustomArray<T, Allocator>& other, const Allocator& allocator) noexcept;
+
+    /*
+     *
+     * CustomArray(CustomArray<T, Allocator>&& other) noexcept;
+     *
+     * Summary:
+     *
+     *   Initialises an array from another array, using move semantics.
+     *
+     * Parameters   : CustomLinkedList<T>&& other
+     *
+     * Description:
+     *
+     *   Switches the memory addreses of the linked-list and other linked-list pointers.
+     *   Sets the pointer addresses of the linked-list other to nullptr.
+     *
+     */
+    CustomArray(CustomArray<T, Allocator>&& other) noexcept;
+
+    /*
+     *
+     * template <typename InputIterator>
+     * CustomArray(InputIterator first, InputIterator last, const Allocator& allocator = Allocator{});
+     *
+     * Summary:
+     *
+     *   Initialises an array from another standard library container.
+     *
+     * Parameters   : InputIterator first, InputIterator last, const Allocator& allocator
+     *
+     * Description:
+     *
+     *   Uses two iterators that are compatible with containers in the standard library.
+     *   Copies the data within a standard library container to the array.
+     *
+     */
+    template <typename InputIterator>
+    CustomArray(InputIterator first, InputIterator last, const Allocator& allocator = Allocator{}) noexcept;
+
+    /*
+     *
+     * ~CustomArray() noexcept;
+     *
+     * Summary:
+     *
+     *   Frees each linked-list node in memory before destoying the linked-list.
+     *
+     * Description:
+     *
+     *   Uses clear to erase all linked-list nodes before destroying the linked-list.
+     *
+     */
+    ~CustomArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_length; }
+    bool empty() const { return !m_length; }
+    std::size_t capacity() const { return m_capacity; }
+
+    // Writes through the pointer are not tracked, so call invalidate() after them.
+    T* data() { return m_array_ptr; }
+    const T* data() const { return m_array_ptr; }
+
+    /*
+     *
+     * std::size_t revision() const;
+     * void invalidate();
+     *
+     * Summary:
+     *
+     *   Returns a counter of changes to the elements, or advances it and forgets the cached sort state.
+     *
+     * Return Value : std::size_t revision
+     *
+     * Description:
+     *
+     *   The revision advances on every insertion, erasure, sort, transform, fill and assignment.
+     *   Handing out a reference, pointer or Iterator through a non-const operator[], data(), begin() or end()
+     *   does not advance it, so reading the elements costs nothing. Writes through one are not seen by the
+     *   cached sort state, the Bloom filter or a CustomHashIndex, so call invalidate() after them.
+     *
+     */
+    std::size_t revision() const { return m_revision; }
+    void invalidate() { m_sort_state = SortState::unknown; ++m_revision; }
+
+    /*
+     *
+     * void reserve(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Allocates memory for at least the specified number of elements.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If capacity is greater than the current capacity, moves the array data into a
+     *   new portion of heap memory that can hold capacity elements.
+     *   The length of the array is unchanged.
+     *
+     */
+    void reserve(std::size_t capacity);
+
+    /*
+     *
+     * void shrinkToFit();
+     *
+     * Summary:
+     *
+     *   Releases any allocated memory that is not used by the array elements.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Moves the array data into a new portion of heap memory equal in size to the array length.
+     *   Clears the array if it is empty.
+     *
+     */
+    void shrinkToFit();
+
+    /*
+     *
+     * void clear();
+     *
+     * Summary:
+     *
+     *   Removes the array data from memory and the array.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Removes the array data from the heap.
+     *   Sets the array pointer to nullptr.
+     *   Sets the array size and capacity to zero.
+     *
+     */
+    void clear();
+
+    /*
+     *
+     * void resize(std::size_t length);
+     *
+     * Summary:
+     *
+     *   Resize function. All elements are kept in the array up to the new length.
+     *
+     * Parameters   : int length
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If length is greater than the capacity, reallocates the array to hold exactly length elements.
+     *   New elements are value initialised.
+     *   Warning! Elements at a position greater than the new length will be dropped from the array.
+     *
+     */
+    void resize(std::size_t length);
+
+    /*
+     *
+     * void insert(int position, const T& value);
+     *
+     * Summary:
+     *
+     *   Inserts data into the array at the specified position.
+     *
+     * Parameters   : int position, const T& value
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls emplace to copy value into the array at position.
+     *   Support negative indexing!
+     *
+     */
+    void insert(int position, const T& value);
+
+    /*
+     *
+     * template <typename... Args>
+     * void emplace(int position, Args&&... args);
+     *
+     * Summary:
+     *
+     *   Constructs a new element in place at the specified position.
+     *
+     * Parameters   : int position, Args&&... args
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If the array is full, grows the capacity geometrically and constructs the element from args
+     *   directly in the newly allocated memory, before moving the existing elements around it.
+     *   Else, an element appended after the last element is constructed directly in the unused memory.
+     *   Otherwise, the element is constructed from args, the values after position are shifted one place
+     *   to the right, and the element is moved into the gap.
+     *   Increments the length by one.
+     *   Support negative indexing!
+     *
+     */
+    template <typename... Args>
+    void emplace(int position, Args&&... args);
+
+    /*
+     *
+     * template <typename InputIterator>
+     * void insert(int position, InputIterator first, InputIterator last);
+     * void insert(int position, std::size_t count, const T& value);
+     *
+     * Summary:
+     *
+     *   Inserts a range of data, or count copies of a value, into the array at the specified position.
+     *
+     * Parameters   : int position, InputIterator first, InputIterator last
+     *                int position, std::size_t count, const T& value
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Uses insertGap to shift the values after position to the right once, by the number of new values,
+     *   and reallocates at most once, instead of once per value as repeated calls to insert would.
+     *   first and last must not refer to elements of this array. value may.
+     *   Support negative indexing!
+     *
+     */
+    template <typename InputIterator,
+              typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+    void insert(int position, InputIterator first, InputIterator last);
+    void insert(int position, std::size_t count, const T& value);
+
+    /*
+     *
+     * void erase(int position);
+     *
+     * Summary:
+     *
+     *   Removes data from the array at the specified position.
+     *
+     * Parameters   : int position
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Shifts the values after position one place to the left, overwriting the data at position.
+     *   Decrements the length by one. The capacity of the array is unchanged.
+     *   Support negative indexing!
+     *
+     */
+    void erase(int position);
+
+    /*
+     *
+     * void erase(int first, int last);
+     *
+     * Summary:
+     *
+     *   Removes the data from the array at positions first up to, but not including, last.
+     *
+     * Parameters   : int first, int last
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Moves the values after last to the left in a single pass, then destroys the unused elements at the end.
+     *   The capacity of the array is unchanged. Nothing is removed if last is not after first.
+     *   Support negative indexing!
+     *
+     */
+    void erase(int first, int last);
+
+    /*
+     *
+     * template <typename Predicate>
+     * std::size_t eraseIf(Predicate pred);
+     *
+     * Summary:
+     *
+     *   Removes every element for which a predicate is true.
+     *
+     * Parameters   : Predicate pred
+     *
+     * Return Value : std::size_t removed
+     *
+     * Description:
+     *
+     *   Moves each element for which pred is false to the left, over the removed elements, in a single O(n)
+     *   pass, then destroys the unused elements at the end. The order of the remaining elements is unchanged.
+     *   Returns the number of elements removed.
+     *
+     */
+    template <typename Predicate>
+    std::size_t eraseIf(Predicate pred);
+
+    /*
+     *
+     * void pushBack(const T& value);
+     *
+     * Summary:
+     *
+     *   Appends a new value to the end of the array.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls the insert function with position equal to the current length of the array.
+     *   Amortised O(1), as the capacity grows geometrically.
+     *   Spare capacity left by popFront is reused before the array is reallocated.
+     *   The rvalue overload moves value into the array instead of copying it.
+     *
+     */
+    void pushBack(const T& value);
+    void pushBack(T&& value);
+
+    /*
+     *
+     * template <typename... Args>
+     * void emplaceBack(Args&&... args);
+     *
+     * Summary:
+     *
+     *   Constructs a new element in place at the end of the array.
+     *
+     * Parameters   : Args&&... args
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls the emplace function with position equal to the current length of the array.
+     *   The element is constructed from args in the array memory, so it is never copied or moved,
+     *   unless the array is later reallocated.
+     *
+     */
+    template <typename... Args>
+    void emplaceBack(Args&&... args);
+
+    /*
+     *
+     * void pushFront(const T& value);
+     *
+     * Summary:
+     *
+     *   Inserts a new value at the start of the array.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If there are unused elements before the first element, the value is written to the
+     *   element immediately before it without moving any data.
+     *   Otherwise, the array data is moved so that spare capacity is kept at both ends.
+     *   Amortised O(1).
+     *
+     */
+    void pushFront(const T& value);
+
+    /*
+     *
+     * void popBack();
+     *
+     * Summary:
+     *
+     *   Removes an existing value from the end of the array.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls the erase function with position equal to the current length of the array.
+     *
+     */
+    void popBack();
+
+    /*
+     *
+     * void popFront();
+     *
+     * Summary:
+     *
+     *   Removes an existing value from the start of the array.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Advances the start of the array by one element without moving any data.
+     *   The released element is kept as spare capacity for pushFront.
+     *   O(1).
+     *
+     */
+    void popFront();
+
+    /*
+     *
+     * void reverse();
+     *
+     * Summary:
+     *
+     *   Reverses the order of the array elements in place.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Iterates forwards and backwards through the array (from the start and end).
+     *   Each iteration, the iterator values are swapped using std::swap.
+     *   This results in a permanent change to the array.
+     *
+     */
+    void reverse();
+
+    /*
+     *
+     * void sort();
+     *
+     * Summary:
+     *
+     *   Sorts the array in ascending order.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sorts the array in ascending order using pdqSort, comparing elements with operator <.
+     *   O(n log n) in the worst case, and O(n) for arrays that are already sorted.
+     *   The sort is not stable. This results in a permanent change to the array.
+     *
+     */
+    void sort();
+
+    /*
+     *
+     * template <typename Compare>
+     * void sort(Compare comp);
+     *
+     * Summary:
+     *
+     *   Sorts the array using a comparison function.
+     *
+     * Parameters   : Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sorts the array using pdqSort, so that comp(a, b) is false for every element b that is before a.
+     *   comp must be a strict weak ordering, such as std::greater<T>() to sort in descending order.
+     *   The sort is not stable. This results in a permanent change to the array.
+     *
+     */
+    template <typename Compare>
+    void sort(Compare comp);
+
+    /*
+     *
+     * void bubbleSort();
+     *
+     * Summary:
+     *
+     *   Legacy alias for sort.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls sort. Kept for existing code; no longer uses the bubblesort algorithm.
+     *
+     */
+    void bubbleSort();
+
+    /*
+     *
+     * void radixSort();
+     *
+     * Summary:
+     *
+     *   Sorts an array of integers or floating point numbers in ascending order using an LSD radix sort.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Only available for integral and IEEE floating point element types, up to 64 bits wide.
+     *   Counts every byte of every element's radixKey in a single pass over the array.
+     *   Performs one stable counting sort pass per byte, least significant first, moving elements
+     *   between the array and a scratch array. Passes where every element has the same byte are skipped.
+     *   O(n) for a fixed element size. Short arrays are sorted with sort instead.
+     *   This results in a permanent change to the array.
+     *
+     */
+    void radixSort();
+
+    /*
+     *
+     * void parallelSort(std::size_t threads = 0);
+     *
+     * Summary:
+     *
+     *   Sorts the array in ascending order using multiple threads.
+     *
+     * Parameters   : std::size_t threads
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Splits the array into one chunk per thread, and sorts each chunk concurrently using pdqSort.
+     *   The threads then find where every thread's share of the output splits each chunk with multiwaySplit.
+     *   Once all of the splits are known, each thread merges its share of every chunk into a scratch array
+     *   with multiwayMerge. The merged data is moved back in parallel.
+     *   If threads is zero, std::thread::hardware_concurrency() threads are used.
+     *   Fewer threads are used if the array is too short to benefit; short arrays are sorted with sort.
+     *   Comparing elements with operator < must not throw. Requires linking with the platform thread library.
+     *   This results in a permanent change to the array.
+     *
+     */
+    void parallelSort(std::size_t threads = 0);
+
+    /*
+     *
+     * bool isSorted() const;
+     *
+     * Summary:
+     *
+     *   Function to state whether the array elements are in ascending order or not.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Returns the cached result if the order of the array is known.
+     *   Else, iterates through the array and caches the result in m_sort_state.
+     *   Returns false if an element is found to be larger than the next element to the right.
+     *   Elements are considered sorted if they are in ascending order.
+     *
+     */
+    bool isSorted() const;
+
+    /*
+     *
+     * int search(const T& value);
+     *
+     * Summary:
+     *
+     *   Searches the array for a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : int index or -1.
+     *
+     * Description:
+     *
+     *   Identifies whether the array is sorted or not, using isSorted().
+     *   The result is cached, so the array is only scanned again after it has been changed in a way that
+     *   could have put it in order. Sorting the array, and any change that keeps it in order, keeps the cache.
+     *   If the array is sorted, performs a binary search using binarySearch().
+     *   If the array isn't sorted, performs a linear search using linearSearch().
+     *   Returns either the index position of the elements that matches value, or -1.
+     *
+     */
+    int search(const T& value);
+
+    /*
+     *
+     * std::size_t count(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the number of elements equal to a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : std::size_t count
+     *
+     * Description:
+     *
+     *   Compares every element with value using simdCount.
+     *   Compares 2 to 32 elements per instruction for int, float, double and char arrays.
+     *
+     */
+    std::size_t count(const T& value) const;
+
+    /*
+     *
+     * CustomArray<int> findAll(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the index of every element equal to a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : CustomArray<int> indexes
+     *
+     * Description:
+     *
+     *   Repeatedly searches for the next element equal to value using simdFind.
+     *   Returns the indexes in ascending order, or an empty array if no element is equal to value.
+     *
+     */
+    CustomArray<int> findAll(const T& value) const;
+
+    /*
+     *
+     * std::size_t lowerBound(const T& value) const;
+     * std::size_t upperBound(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the index of the first element that is not less than, or greater than, a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : std::size_t index
+     *
+     * Description:
+     *
+     *   The array must be sorted in ascending order. Returns size() if there is no such element.
+     *   Searches with branchlessBound, which takes the same log2(n) steps for every value and prefetches
+     *   the next element it may compare.
+     *
+     */
+    std::size_t lowerBound(const T& value) const;
+    std::size_t upperBound(const T& value) const;
+
+    /*
+     *
+     * std::pair<std::size_t, std::size_t> equalRange(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the range of indexes of the elements equal to a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : std::pair<std::size_t, std::size_t> { lowerBound(value), upperBound(value) }
+     *
+     * Description:
+     *
+     *   The array must be sorted in ascending order. The range is empty if no element is equal to value.
+     *   The upper bound is searched for only among the elements from the lower bound on.
+     *
+     */
+    std::pair<std::size_t, std::size_t> equalRange(const T& value) const;
+
+    /*
+     *
+     * CustomArray<int> searchMany(const CustomArray<T, Allocator>& keys);
+     *
+     * Summary:
+     *
+     *   Searches the array for each of several values.
+     *
+     * Parameters   : const CustomArray<T, Allocator>& keys
+     *
+     * Return Value : CustomArray<int> indexes
+     *
+     * Description:
+     *
+     *   Returns an array with one element per key, holding what search would return for that key.
+     *   If the array is sorted, the keys are searched for searchManyLanes at a time with interleavedLowerBounds,
+     *   so the cache misses of several searches overlap. This is much faster than calling search once per key
+     *   when the array does not fit in the cache. Else, each key is searched for linearly.
+     *
+     */
+    CustomArray<int> searchMany(const CustomArray<T, Allocator>& keys);
+
+    /*
+     *
+     * void enableBloomFilter(double falsePositiveRate = 0.01);
+     * void disableBloomFilter();
+     *
+     * Summary:
+     *
+     *   Adds, or removes, a Bloom filter of the elements, so that searches for missing values return at once.
+     *
+     * Parameters   : double falsePositiveRate
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   While enabled, search, count and findAll first check the value against a CustomBloomFilter of the
+     *   elements, and return without scanning the array if it is certainly missing, reading one cache line.
+     *   A missing value gets past the filter with probability falsePositiveRate, and is then searched for as usual.
+     *   insert, pushBack and the other insertions add their values to the filter as they go. Member functions
+     *   that change elements in place, such as transform, fill, reverse or sorting, leave it out of date, and it
+     *   is rebuilt by the next search. Writes through operator[], data(), an Iterator or a view are not seen,
+     *   so call invalidate() after them. The filter uses std::hash<T>, and about 11 bits per element at 1%.
+     *   The filter belongs to this array object: copies and moves of the array do not have one.
+     *
+     */
+    void enableBloomFilter(double falsePositiveRate = 0.01);
+    void disableBloomFilter() { m_bloom_ptr.reset(nullptr); }
+    bool hasBloomFilter() const { return m_bloom_ptr != nullptr; }
+
+    // Returns false if no element is equal to value, according to the Bloom filter. Else, or if there is no
+    // Bloom filter, returns true.
+    bool mayContain(const T& value) const;
+
+    /*
+     *
+     * SumType sum(std::size_t threads = 1) const;
+     * double mean(std::size_t threads = 1) const;
+     *
+     * Summary:
+     *
+     *   Returns the sum, or the arithmetic mean, of the elements.
+     *
+     * Parameters   : std::size_t threads
+     *
+     * Return Value : SumType sum, double mean
+     *
+     * Description:
+     *
+     *   Adds the elements using simdSum, which uses AVX2 or SSE2 kernels for int, float and double arrays.
+     *   Sums of int arrays are long long. The sum of an empty array is zero, and so is its mean.
+     *   Large arrays can be split between threads, as for minMax.
+     *
+     */
+    SumType sum(std::size_t threads = 1) const;
+    double mean(std::size_t threads = 1) const;
+
+    /*
+     *
+     * std::pair<T, T> minMax(std::size_t threads = 1) const;
+     *
+     * Summary:
+     *
+     *   Returns the least and greatest elements.
+     *
+     * Parameters   : std::size_t threads
+     *
+     * Return Value : std::pair<T, T> least and greatest
+     *
+     * Description:
+     *
+     *   If the array is known to be sorted, returns the first and last elements. Else, compares every element
+     *   using simdMinMax. Returns a pair of value initialised elements if the array is empty.
+     *   If threads is not one, arrays of more than parallelReduceGrain elements are split into one chunk per
+     *   thread, which are scanned concurrently. If threads is zero, std::thread::hardware_concurrency() is used.
+     *
+     */
+    std::pair<T, T> minMax(std::size_t threads = 1) const;
+
+    /*
+     *
+     * SumType dot(const CustomArray<T, Allocator>& other, std::size_t threads = 1) const;
+     *
+     * Summary:
+     *
+     *   Returns the dot product of this array and another.
+     *
+     * Parameters   : const CustomArray<T, Allocator>& other, std::size_t threads
+     *
+     * Return Value : SumType product
+     *
+     * Description:
+     *
+     *   Returns the sum of the products of elements at the same position, using simdDot. If the arrays have
+     *   different lengths, the extra elements of the longer one are ignored. Threads are used as for minMax.
+     *
+     */
+    SumType dot(const CustomArray<T, Allocator>& other, std::size_t threads = 1) const;
+
+    /*
+     *
+     * template <typename Function>
+     * void transform(Function function, std::size_t threads = 1);
+     *
+     * Summary:
+     *
+     *   Replaces every element x with function(x).
+     *
+     * Parameters   : Function function, std::size_t threads
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Uses simdTransform, which compiles the loop for AVX2 on processors that support it, so simple
+     *   arithmetic functions are vectorised. Threads are used as for minMax, in which case function is called
+     *   concurrently and must be safe to do so.
+     *
+     */
+    template <typename Function>
+    void transform(Function function, std::size_t threads = 1);
+
+    // Assigns value to every element using simdFill, keeping the length. Threads are used as for minMax.
+    void fill(const T& value, std::size_t threads = 1);
+
+    /*
+     *
+     * void swap(CustomArray<T, Allocator>& other);
+     *
+     * Summary:
+     *
+     *   Swaps array data nodes with another array.
+     *
+     * Parameters   : CustomArray<T, Allocator>& other
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Switches the m_array_ptr, length, capacity and front capacity of the array with other.
+     *   The allocators are switched if the Allocator type propagates on swap. Else, they must be equal.
+     *
+     */
+    void swap(CustomArray<T, Allocator>& other);
+
+    Allocator getAllocator() const { return m_allocator; }
+
+    /*
+     *
+     * T& operator[](int position);
+     *
+     * Summary:
+     *
+     *   Index operator overload.
+     *
+     * Return Value: T& m_array_ptr[position]
+     *
+     * Description:
+     *
+     *   Returns the element of the array at the specified position.
+     *   Support negative indexing!
+     *   Writes through the reference are not tracked, so call invalidate() after them.
+     *
+     */
+    T& operator[](int position);
+
+    /*
+     *
+     * T& operator[](int position);
+     *
+     * Summary:
+     *
+     *   Index operator overload.
+     *
+     * Return Value: const T& m_array_ptr[position]
+     *
+     * Description:
+     *
+     *   Returns the element of the array at the specified position.
+     *   Support negative indexing!
+     *
+     */
+    const T& operator[](int position) const;
+
+    /*
+     *
+     * CustomArray& operator=(const CustomArray<T, Allocator>& other);
+     *
+     * Summary:
+     *
+     *   Copy assignment operator overload.
+     *
+     * Return Value: *this
+     *
+     * Description:
+     *
+     *   Clears the existing array, and takes the allocator of other if it propagates on copy assignment.
+     *   Allocates a new portion of memory equal in size and structure to the array other.
+     *   Using deepCopy, copies the values of the other linked-list to the newly allocated memory.
+     *
+     */
+    CustomArray& operator=(const CustomArray<T, Allocator>& other);
+
+    /*
+     *
+     * CustomArray& operator=(CustomArray<T, Allocator>&& other);
+     *
+     * Summary:
+     *
+     *   Move assignment operator overload.
+     *
+     * Return Value: *this
+     *
+     * Description:
+     *
+     *   Switches array pointer addresses and lengths with the temporary/anonymous array object other.
+     *   If the allocators are not equal and do not propagate on move assignment, the elements of other
+     *   are moved into memory allocated by this array's allocator instead.
+     *
+     */
+    CustomArray& operator=(CustomArray<T, Allocator>&& other);
+
+    /*
+     *
+     * CustomArray& operator=(std::initializer_list<T> elements);
+     *
+     * Summary:
+     *
+     *   Copy assignment operator overload from a std::initializer_list.
+     *
+     * Return Value: *this
+     *
+     * Description:
+     *
+     *   Uses the copy and swap idiom.
+     *   Creates a temporary array with the std::initializer_list elements.
+     *   Switches pointer addresses and lengths with the temporary array.
+     *
+     */
+    CustomArray& operator=(std::initializer_list<T> elements);
+
+    // CustomSmallArray, CustomMappedArray and CustomArrayView share the sort engine of CustomArray.
+    template <typename U, std::size_t M, typename OtherAllocator>
+    friend class CustomSmallArray;
+    template <typename U>
+    friend class CustomMappedArray;
+    template <typename U>
+    friend class CustomArrayView;
+
+    // The view overloads of merge and the set operations share the set engine of CustomArray.
+    template <typename U, typename V>
+    friend CustomArray<typename std::remove_const<U>::type> merge(CustomArrayView<U> A, CustomArrayView<V> B);
+    template <typename U, typename V>
+    friend CustomArray<typename std::remove_const<U>::type> setUnion(CustomArrayView<U> A, CustomArrayView<V> B);
+    template <typename U, typename V>
+    friend CustomArray<typename std::remove_const<U>::type> setDifference(CustomArrayView<U> A, CustomArrayView<V> B);
+    template <typename U, typename V>
+    friend CustomArray<typename std::remove_const<U>::type> setIntersection(CustomArrayView<U> A, CustomArrayView<V> B);
+
+    // Fully specialised template friend function declarations.
+    friend std::ostream& operator<<<T, Allocator>(std::ostream& out, const CustomArray<T, Allocator>& arr);
+    friend CustomArray<T, Allocator> merge<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
+    friend CustomArray<T, Allocator> setUnion<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
+    friend CustomArray<T, Allocator> setDifference<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
+    friend CustomArray<T, Allocator> setIntersection<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B);
+    friend CustomArray<T, Allocator> parallelMerge<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads);
+    friend CustomArray<T, Allocator> parallelSetUnion<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads);
+    friend CustomArray<T, Allocator> parallelSetDifference<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads);
+    friend CustomArray<T, Allocator> parallelSetIntersection<T, Allocator>(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads);
+    friend void saveBinary<T, Allocator>(const CustomArray<T, Allocator>& arr, const char* path);
+    friend void loadBinary<T, Allocator>(CustomArray<T, Allocator>& arr, const char* path);
+
+    /*
+     *
+     *   Class Name: Iterator
+     *
+     *   Purpose:
+     *     A bidirectional non-const iterator for CustomArray<T, Allocator> objects.
+     *
+     */
+    class Iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+    private:
+        pointer m_ptr;
+    public:
+        Iterator(pointer ptr = nullptr) : m_ptr{ ptr } {}
+        Iterator(const Iterator& other) : m_ptr{ other.m_ptr } {}
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        Iterator& operator++() { ++m_ptr; return *this; }
+        Iterator operator++(int) { Iterator tmp{ *this }; ++(*this); return tmp; }
+        Iterator& operator--() { --m_ptr; return *this; }
+        Iterator operator--(int) { Iterator tmp{ *this }; --(*this); return tmp; }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_ptr == b.m_ptr; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_ptr != b.m_ptr; }
+    };
+
+    // Writes through an Iterator are not tracked, so call invalidate() after them.
+    Iterator begin() { return Iterator{ m_array_ptr }; }
+    Iterator end() { return Iterator{ m_array_ptr + m_length }; }
+
+    /*
+     *
+     *   Class Name: ConstIterator
+     *
+     *   Purpose:
+     *     A bidirectional const iterator for const CustomArray<T, Allocator> objects.
+     *
+     */
+    class ConstIterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+    private:
+        pointer m_ptr;
+    public:
+        ConstIterator(pointer ptr = nullptr) : m_ptr{ ptr } {}
+        ConstIterator(const ConstIterator& other) : m_ptr{ other.m_ptr } {}
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        ConstIterator& operator++() { ++m_ptr; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp{ *this }; ++(*this); return tmp; }
+        ConstIterator& operator--() { --m_ptr; return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp{ *this }; --(*this); return tmp; }
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.m_ptr == b.m_ptr; }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.m_ptr != b.m_ptr; }
+    };
+
+    ConstIterator begin() const { return ConstIterator{ m_array_ptr }; }
+    ConstIterator end() const { return ConstIterator{ m_array_ptr + m_length }; }
+
+};
+
+#ifdef CUSTOMARRAY_PMR
+// An array that allocates from a std::pmr::memory_resource, e.g. CustomPmrArray<int> arr{ &resource };
+template <typename T>
+using CustomPmrArray = CustomArray<T, std::pmr::polymorphic_allocator<T>>;
+#endif
+
+
+// Private member function definitions begin here.
+
+template <typename T, typename Allocator>
+T* CustomArray<T, Allocator>::allocateBuffer(std::size_t capacity)
+{
+    return AllocTraits::allocate(m_allocator, capacity);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::deallocateBuffer(T* buffer, std::size_t capacity)
+{
+    AllocTraits::deallocate(m_allocator, buffer, capacity);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::constructCopies(const T* first, const T* last, T* destination)
+{
+    if (std::is_trivially_copyable<T>::value)
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void*>(destination), first, static_cast<std::size_t>(last - first) * sizeof(T));
+        }
+        return;
+    }
+
+    T* constructed{ destination };
+    try
+    {
+        for (; first != last; ++first, ++constructed)
+        {
+            AllocTraits::construct(m_allocator, constructed, *first);
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::constructMoves(T* first, T* last, T* destination)
+{
+    if (std::is_trivially_copyable<T>::value)
+    {
+        constructCopies(first, last, destination);
+        return;
+    }
+
+    T* constructed{ destination };
+    try
+    {
+        for (; first != last; ++first, ++constructed)
+        {
+            AllocTraits::construct(m_allocator, constructed, std::move_if_noexcept(*first));
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::constructValues(T* first, T* last)
+{
+    T* constructed{ first };
+    try
+    {
+        for (; constructed != last; ++constructed)
+        {
+            AllocTraits::construct(m_allocator, constructed);
+        }
+    }
+    catch (...)
+    {
+        destroyRange(first, constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::destroyRange(T* first, T* last)
+{
+    if (std::is_trivially_destructible<T>::value) { return; }
+
+    for (; first != last; ++first)
+    {
+        AllocTraits::destroy(m_allocator, first);
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::swapData(CustomArray<T, Allocator>& other)
+{
+    std::swap(m_array_ptr,other.m_array_ptr);
+    std::swap(m_length,other.m_length);
+    std::swap(m_capacity,other.m_capacity);
+    std::swap(m_front,other.m_front);
+    std::swap(m_sort_state,other.m_sort_state);
+    ++m_revision;
+    ++other.m_revision;
+}
+
+template <typename T, typename Allocator>
+std::ostream& CustomArray<T, Allocator>::display(std::ostream& out) const
+{
+    // Characters are printed as a string, without spaces.
+    const char* separator{ std::is_same<T, char>::value ? "" : " " };
+    auto it{ begin() };
+    T* last{ m_array_ptr + m_length - 1 };
+    if (m_length)
+    {
+        do
+        {
+            if (it == last)
+            {
+                out << *it;
+            }
+            else
+            {
+                out << *it << separator;
+            }
+        }
+        while (++it != end());
+    }
+    return out;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::deepCopy(const CustomArray<T, Allocator> &other)
+{
+    ++m_revision;
+    if (other.m_length > 0)
+    {
+        T* new_array_ptr{ allocateBuffer(other.m_length) };
+        try
+        {
+            constructCopies(other.m_array_ptr, other.m_array_ptr + other.m_length, new_array_ptr);
+        }
+        catch (...)
+        {
+            deallocateBuffer(new_array_ptr, other.m_length);
+            throw;
+        }
+        m_length = other.m_length;
+        m_capacity = other.m_length;
+        m_sort_state = other.m_sort_state;
+        m_array_ptr = new_array_ptr;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::recordInsert(int position, const T& value)
+{
+    advanceRevision(&value, 1);
+    if (m_sort_state != SortState::ascending) { return; }
+
+    if ((position > 0 && m_array_ptr[position - 1] > value)
+        || (position < static_cast<int>(m_length) && value > m_array_ptr[position]))
+    {
+        m_sort_state = SortState::unsorted;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::reallocate(std::size_t capacity, std::size_t front)
+{
+    T* new_buffer_ptr { allocateBuffer(capacity) };
+    auto elementsToMove{ (capacity - front > m_length) ? m_length : capacity - front };
+    try
+    {
+        constructMoves(m_array_ptr, m_array_ptr + elementsToMove, new_buffer_ptr + front);
+    }
+    catch (...)
+    {
+        deallocateBuffer(new_buffer_ptr, capacity);
+        throw;
+    }
+    if (!isNull())
+    {
+        destroyRange(m_array_ptr, m_array_ptr + m_length);
+        deallocateBuffer(m_array_ptr - m_front, m_capacity);
+    }
+    m_array_ptr = new_buffer_ptr + front;
+    m_capacity = capacity;
+    m_front = front;
+    m_length = elementsToMove;
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::nextCapacity(std::size_t minimum) const
+{
+    std::size_t grown{ m_capacity ? m_capacity * 2 : 1 };
+    return (grown > minimum) ? grown : minimum;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::shiftData(std::size_t front)
+{
+    if (!std::is_nothrow_move_constructible<T>::value && !std::is_trivially_copyable<T>::value)
+    {
+        reallocate(m_capacity, front);
+        return;
+    }
+
+    T* new_array_ptr{ m_array_ptr - m_front + front };
+    relocateRange(m_array_ptr, m_array_ptr + m_length, new_array_ptr);
+    m_array_ptr = new_array_ptr;
+    m_front = front;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::relocateRange(T* first, T* last, T* destination)
+{
+    if (std::is_trivially_copyable<T>::value)
+    {
+        if (first != last)
+        {
+            std::memmove(static_cast<void*>(destination), first, static_cast<std::size_t>(last - first) * sizeof(T));
+        }
+    }
+    else if (destination < first)
+    {
+        for (; first != last; ++first, ++destination)
+        {
+            AllocTraits::construct(m_allocator, destination, std::move(*first));
+            AllocTraits::destroy(m_allocator, first);
+        }
+    }
+    else if (destination > first)
+    {
+        destination += last - first;
+        while (last != first)
+        {
+            --last;
+            --destination;
+            AllocTraits::construct(m_allocator, destination, std::move(*last));
+            AllocTraits::destroy(m_allocator, last);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::clampPosition(int position) const
+{
+    if (position < 0)
+    {
+        if (empty()) { return 0; }
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    return (static_cast<std::size_t>(position) > m_length) ? m_length : static_cast<std::size_t>(position);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::recordInsertRange(std::size_t position, std::size_t count)
+{
+    advanceRevision(m_array_ptr + position, count);
+    if (m_sort_state != SortState::ascending || m_length < 2) { return; }
+
+    std::size_t first{ (position > 0) ? position : 1 };
+    std::size_t last{ (position + count < m_length) ? position + count : m_length - 1 };
+    for (std::size_t i{ first }; i <= last; ++i)
+    {
+        if (m_array_ptr[i - 1] > m_array_ptr[i])
+        {
+            m_sort_state = SortState::unsorted;
+            return;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::advanceRevision(const T* inserted, std::size_t count)
+{
+    bool bloom_current{ m_bloom_ptr && m_bloom_revision == m_revision };
+    ++m_revision;
+    if (!bloom_current || m_bloom_ptr->size() + count > m_bloom_ptr->capacity()) { return; }
+
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        m_bloom_ptr->insert(inserted[i]);
+    }
+    m_bloom_revision = m_revision;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::refreshBloom() const
+{
+    if (m_bloom_revision == m_revision) { return; }
+
+    m_bloom_ptr->reset((m_length > 512) ? 2 * m_length : 1024, m_bloom_ptr->targetRate());
+    for (std::size_t i{ 0 }; i < m_length; ++i)
+    {
+        m_bloom_ptr->insert(m_array_ptr[i]);
+    }
+    m_bloom_revision = m_revision;
+}
+
+template <typename T, typename Allocator>
+template <typename Construct>
+void CustomArray<T, Allocator>::insertGap(std::size_t position, std::size_t count, Construct construct)
+{
+    if (count == 0) { return; }
+
+    // The gap is opened with relocateRange only for elements that can be moved without throwing.
+    bool relocatable{ std::is_nothrow_move_constructible<T>::value || std::is_trivially_copyable<T>::value };
+    if (relocatable && m_front + m_length + count > m_capacity && m_capacity - m_length >= count && m_front > m_length)
+    {
+        // More unused elements are before the array than in it, so they are reclaimed instead of reallocating.
+        shiftData(0);
+    }
+
+    if (m_front + m_length + count > m_capacity)
+    {
+        std::size_t new_capacity{ nextCapacity(m_length + count) };
+        T* new_array_ptr{ allocateBuffer(new_capacity) };
+        T* inserted_ptr{ new_array_ptr + position };
+        try
+        {
+            construct(inserted_ptr);
+        }
+        catch (...)
+        {
+            deallocateBuffer(new_array_ptr, new_capacity);
+            throw;
+        }
+        try
+        {
+            constructMoves(m_array_ptr, m_array_ptr + position, new_array_ptr);
+            try
+            {
+                constructMoves(m_array_ptr + position, m_array_ptr + m_length, inserted_ptr + count);
+            }
+            catch (...)
+            {
+                destroyRange(new_array_ptr, inserted_ptr);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            destroyRange(inserted_ptr, inserted_ptr + count);
+            deallocateBuffer(new_array_ptr, new_capacity);
+            throw;
+        }
+        if (!isNull())
+        {
+            destroyRange(m_array_ptr, m_array_ptr + m_length);
+            deallocateBuffer(m_array_ptr - m_front, m_capacity);
+        }
+        m_array_ptr = new_array_ptr;
+        m_capacity = new_capacity;
+        m_front = 0;
+        m_length += count;
+    }
+    else if (relocatable)
+    {
+        T* gap_ptr{ m_array_ptr + position };
+        relocateRange(gap_ptr, m_array_ptr + m_length, gap_ptr + count);
+        try
+        {
+            construct(gap_ptr);
+        }
+        catch (...)
+        {
+            relocateRange(gap_ptr + count, m_array_ptr + m_length + count, gap_ptr);
+            throw;
+        }
+        m_length += count;
+    }
+    else
+    {
+        // Elements that may throw when moved are shifted as emplace shifts them. The new elements are built in a
+        // scratch buffer first, so the array is unchanged if one of them throws.
+        T* buffer_ptr{ allocateBuffer(count) };
+        try
+        {
+            construct(buffer_ptr);
+        }
+        catch (...)
+        {
+            deallocateBuffer(buffer_ptr, count);
+            throw;
+        }
+        try
+        {
+            // Every element moved past the old end is constructed in turn at m_array_ptr + m_length,
+            // so m_length counts exactly the constructed elements if a move throws.
+            std::size_t tail{ m_length - position };
+            std::size_t old_length{ m_length };
+            if (tail >= count)
+            {
+                for (std::size_t source{ old_length - count }; source < old_length; ++source)
+                {
+                    AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(m_array_ptr[source]));
+                    ++m_length;
+                }
+                std::move_backward(m_array_ptr + position, m_array_ptr + old_length - count, m_array_ptr + old_length);
+                std::move(buffer_ptr, buffer_ptr + count, m_array_ptr + position);
+            }
+            else
+            {
+                for (std::size_t source{ tail }; source < count; ++source)
+                {
+                    AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(buffer_ptr[source]));
+                    ++m_length;
+                }
+                for (std::size_t source{ position }; source < old_length; ++source)
+                {
+                    AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(m_array_ptr[source]));
+                    ++m_length;
+                }
+                std::move(buffer_ptr, buffer_ptr + tail, m_array_ptr + position);
+            }
+        }
+        catch (...)
+        {
+            destroyRange(buffer_ptr, buffer_ptr + count);
+            deallocateBuffer(buffer_ptr, count);
+            throw;
+        }
+        destroyRange(buffer_ptr, buffer_ptr + count);
+        deallocateBuffer(buffer_ptr, count);
+    }
+    recordInsertRange(position, count);
+}
+
+template <typename T, typename Allocator>
+template <typename ForwardIterator>
+void CustomArray<T, Allocator>::insertRange(std::size_t position, ForwardIterator first, ForwardIterator last,
+                                            std::true_type)
+{
+    std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+    insertGap(position, count, [this, first, count](T* destination)
+    {
+        constructFrom(first, count, destination);
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator>
+void CustomArray<T, Allocator>::insertRange(std::size_t position, InputIterator first, InputIterator last,
+                                            std::false_type)
+{
+    CustomArray<T, Allocator> buffer{ m_allocator };
+    for (; first != last; ++first)
+    {
+        buffer.emplaceBack(*first);
+    }
+    T* source{ buffer.m_array_ptr };
+    std::size_t count{ buffer.m_length };
+    insertGap(position, count, [this, source, count](T* destination)
+    {
+        constructFrom(std::make_move_iterator(source), count, destination);
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename ForwardIterator>
+void CustomArray<T, Allocator>::constructFrom(ForwardIterator first, std::size_t count, T* destination)
+{
+    std::size_t constructed{ 0 };
+    try
+    {
+        for (; constructed < count; ++constructed, ++first)
+        {
+            AllocTraits::construct(m_allocator, destination + constructed, *first);
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, destination + constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::constructFill(T* destination, std::size_t count, const T& value)
+{
+    std::size_t constructed{ 0 };
+    try
+    {
+        for (; constructed < count; ++constructed)
+        {
+            AllocTraits::construct(m_allocator, destination + constructed, value);
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, destination + constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+int CustomArray<T, Allocator>::linearSearch(const T& value)
+{
+    std::size_t index{ simdFind(m_array_ptr, m_length, value) };
+    return (index < m_length) ? static_cast<int>(index) : -1;
+}
+
+template <typename T, typename Allocator>
+int CustomArray<T, Allocator>::binarySearch(const T& value)
+{
+    assert(isSorted() && "Array elements must be in ascending order.");
+    std::size_t index{ branchlessBound(m_array_ptr, m_length, [&value](const T& element) { return element < value; }) };
+    return (index < m_length && m_array_ptr[index] == value) ? static_cast<int>(index) : -1;
+}
+
+template <typename T, typename Allocator>
+template <typename Before>
+std::size_t CustomArray<T, Allocator>::branchlessBound(const T* data, std::size_t length, Before before)
+{
+    if (length == 0) { return 0; }
+
+    // The answer is always in [base, base + length].
+    const T* base{ data };
+    while (length > 1)
+    {
+        std::size_t half{ length / 2 };
+        std::size_t next{ (length - half) / 2 };
+        simdPrefetch(base + next);
+        simdPrefetch(base + half + next);
+        base = before(base[half]) ? base + half : base;
+        length -= half;
+    }
+    return static_cast<std::size_t>(base - data) + (before(*base) ? 1 : 0);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::interleavedLowerBounds(const T* data, std::size_t length,
+                                                       const T* keys, std::size_t count, std::size_t* bounds)
+{
+    if (length == 0)
+    {
+        std::fill(bounds, bounds + count, std::size_t{});
+        return;
+    }
+
+    const T* base[searchManyLanes];
+    for (std::size_t first{}; first < count; first += searchManyLanes)
+    {
+        std::size_t lanes{ (count - first < searchManyLanes) ? count - first : searchManyLanes };
+        const T* key{ keys + first };
+        for (std::size_t lane{}; lane < lanes; ++lane)
+        {
+            base[lane] = data;
+        }
+
+        // Every search has the same length, so each step takes the same half of every lane's range.
+        std::size_t remaining{ length };
+        while (remaining > 1)
+        {
+            std::size_t half{ remaining / 2 };
+            std::size_t next{ (remaining - half) / 2 };
+            for (std::size_t lane{}; lane < lanes; ++lane)
+            {
+                const T* laneBase{ base[lane] };
+                simdPrefetch(laneBase + next);
+                simdPrefetch(laneBase + half + next);
+                base[lane] = (laneBase[half] < key[lane]) ? laneBase + half : laneBase;
+            }
+            remaining -= half;
+        }
+        for (std::size_t lane{}; lane < lanes; ++lane)
+        {
+            bounds[first + lane] = static_cast<std::size_t>(base[lane] - data) + ((*base[lane] < key[lane]) ? 1 : 0);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::pdqSort(T* first, T* last, Compare comp, int badAllowed, bool leftmost)
+{
+    while (true)
+    {
+        std::ptrdiff_t size{ last - first };
+        if (size < insertionSortThreshold)
+        {
+            insertionSort(first, last, comp, leftmost);
+            return;
+        }
+
+        // The pivot is moved to *first.
+        std::ptrdiff_t half{ size / 2 };
+        if (size > nintherThreshold)
+        {
+            sort3(first, first + half, last - 1, comp);
+            sort3(first + 1, first + (half - 1), last - 2, comp);
+            sort3(first + 2, first + (half + 1), last - 3, comp);
+            sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            std::swap(*first, *(first + half));
+        }
+        else
+        {
+            sort3(first + half, first, last - 1, comp);
+        }
+
+        // If the pivot equals the element before the range, every element equal to it is already in place.
+        if (!leftmost && !comp(*(first - 1), *first))
+        {
+            first = partitionLeft(first, last, comp) + 1;
+            continue;
+        }
+
+        std::pair<T*, bool> partition{ partitionRight(first, last, comp) };
+        T* pivot{ partition.first };
+        std::ptrdiff_t leftSize{ pivot - first };
+        std::ptrdiff_t rightSize{ last - (pivot + 1) };
+
+        if (leftSize < size / 8 || rightSize < size / 8)
+        {
+            if (--badAllowed == 0)
+            {
+                heapSort(first, last, comp);
+                return;
+            }
+
+            // Swap elements away from their positions to break up patterns that cause bad pivots.
+            if (leftSize >= insertionSortThreshold)
+            {
+                std::swap(*first, *(first + leftSize / 4));
+                std::swap(*(pivot - 1), *(pivot - leftSize / 4));
+                if (leftSize > nintherThreshold)
+                {
+                    std::swap(*(first + 1), *(first + (leftSize / 4 + 1)));
+                    std::swap(*(first + 2), *(first + (leftSize / 4 + 2)));
+                    std::swap(*(pivot - 2), *(pivot - (leftSize / 4 + 1)));
+                    std::swap(*(pivot - 3), *(pivot - (leftSize / 4 + 2)));
+                }
+            }
+            if (rightSize >= insertionSortThreshold)
+            {
+                std::swap(*(pivot + 1), *(pivot + (1 + rightSize / 4)));
+                std::swap(*(last - 1), *(last - rightSize / 4));
+                if (rightSize > nintherThreshold)
+                {
+                    std::swap(*(pivot + 2), *(pivot + (2 + rightSize / 4)));
+                    std::swap(*(pivot + 3), *(pivot + (3 + rightSize / 4)));
+                    std::swap(*(last - 2), *(last - (1 + rightSize / 4)));
+                    std::swap(*(last - 3), *(last - (2 + rightSize / 4)));
+                }
+            }
+        }
+        else if (partition.second
+                 && partialInsertionSort(first, pivot, comp)
+                 && partialInsertionSort(pivot + 1, last, comp))
+        {
+            return;
+        }
+
+        // Recurse into the left partition and loop on the right, so the stack depth stays O(log n).
+        pdqSort(first, pivot, comp, badAllowed, leftmost);
+        first = pivot + 1;
+        leftmost = false;
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+std::pair<T*, bool> CustomArray<T, Allocator>::partitionRight(T* first, T* last, Compare comp)
+{
+    T pivot{ std::move(*first) };
+    T* left{ first };
+    T* right{ last };
+
+    while (comp(*++left, pivot)) {}
+
+    if (left - 1 == first)
+    {
+        while (left < right && !comp(*--right, pivot)) {}
+    }
+    else
+    {
+        while (!comp(*--right, pivot)) {}
+    }
+
+    bool alreadyPartitioned{ left >= right };
+    while (left < right)
+    {
+        std::swap(*left, *right);
+        while (comp(*++left, pivot)) {}
+        while (!comp(*--right, pivot)) {}
+    }
+
+    T* pivotPosition{ left - 1 };
+    *first = std::move(*pivotPosition);
+    *pivotPosition = std::move(pivot);
+    return { pivotPosition, alreadyPartitioned };
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+T* CustomArray<T, Allocator>::partitionLeft(T* first, T* last, Compare comp)
+{
+    T pivot{ std::move(*first) };
+    T* left{ first };
+    T* right{ last };
+
+    while (comp(pivot, *--right)) {}
+
+    if (right + 1 == last)
+    {
+        while (left < right && !comp(pivot, *++left)) {}
+    }
+    else
+    {
+        while (!comp(pivot, *++left)) {}
+    }
+
+    while (left < right)
+    {
+        std::swap(*left, *right);
+        while (comp(pivot, *--right)) {}
+        while (!comp(pivot, *++left)) {}
+    }
+
+    *first = std::move(*right);
+    *right = std::move(pivot);
+    return right;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::insertionSort(T* first, T* last, Compare comp, bool leftmost)
+{
+    if (first == last) { return; }
+
+    for (T* current{ first + 1 }; current != last; ++current)
+    {
+        if (comp(*current, *(current - 1)))
+        {
+            T value{ std::move(*current) };
+            T* hole{ current };
+            do
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            }
+            while ((!leftmost || hole != first) && comp(value, *(hole - 1)));
+            *hole = std::move(value);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+bool CustomArray<T, Allocator>::partialInsertionSort(T* first, T* last, Compare comp)
+{
+    if (first == last) { return true; }
+
+    std::size_t moves{ 0 };
+    for (T* current{ first + 1 }; current != last; ++current)
+    {
+        if (comp(*current, *(current - 1)))
+        {
+            T value{ std::move(*current) };
+            T* hole{ current };
+            do
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            }
+            while (hole != first && comp(value, *(hole - 1)));
+            *hole = std::move(value);
+
+            moves += static_cast<std::size_t>(current - hole);
+            if (moves > partialInsertionSortLimit) { return false; }
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::heapSort(T* first, T* last, Compare comp)
+{
+    std::ptrdiff_t size{ last - first };
+
+    // Moves the element at root down the heap of the first length elements until both children are no greater.
+    auto siftDown = [first, comp](std::ptrdiff_t root, std::ptrdiff_t length)
+    {
+        T value{ std::move(first[root]) };
+        std::ptrdiff_t child{ 2 * root + 1 };
+        while (child < length)
+        {
+            if (child + 1 < length && comp(first[child], first[child + 1])) { ++child; }
+            if (!comp(value, first[child])) { break; }
+            first[root] = std::move(first[child]);
+            root = child;
+            child = 2 * root + 1;
+        }
+        first[root] = std::move(value);
+    };
+
+    for (std::ptrdiff_t root{ size / 2 }; root > 0; --root)
+    {
+        siftDown(root - 1, size);
+    }
+    for (std::ptrdiff_t end{ size - 1 }; end > 0; --end)
+    {
+        std::swap(first[0], first[end]);
+        siftDown(0, end);
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::sort3(T* a, T* b, T* c, Compare comp)
+{
+    if (comp(*b, *a)) { std::swap(*a, *b); }
+    if (comp(*c, *b)) { std::swap(*b, *c); }
+    if (comp(*b, *a)) { std::swap(*a, *b); }
+}
+
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::RadixKey CustomArray<T, Allocator>::radixKey(const T& value)
+{
+    return radixKey(value, std::integral_constant<bool, std::is_floating_point<T>::value>{});
+}
+
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::RadixKey CustomArray<T, Allocator>::radixKey(const T& value, std::true_type)
+{
+    const RadixKey signBit{ static_cast<RadixKey>(RadixKey{ 1 } << (sizeof(T) * 8 - 1)) };
+    RadixKey bits{};
+    std::memcpy(&bits, &value, sizeof(T));
+    return (bits & signBit) ? static_cast<RadixKey>(~bits) : static_cast<RadixKey>(bits | signBit);
+}
+
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::RadixKey CustomArray<T, Allocator>::radixKey(const T& value, std::false_type)
+{
+    const RadixKey signBit{ static_cast<RadixKey>(RadixKey{ 1 } << (sizeof(T) * 8 - 1)) };
+    RadixKey bits{};
+    std::memcpy(&bits, &value, sizeof(T));
+    return std::is_signed<T>::value ? static_cast<RadixKey>(bits ^ signBit) : bits;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+const T* CustomArray<T, Allocator>::rangeLowerBound(const T* first, const T* last, const T& value, Compare comp)
+{
+    std::ptrdiff_t count{ last - first };
+    while (count > 0)
+    {
+        std::ptrdiff_t half{ count / 2 };
+        if (comp(first[half], value))
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+const T* CustomArray<T, Allocator>::rangeUpperBound(const T* first, const T* last, const T& value, Compare comp)
+{
+    std::ptrdiff_t count{ last - first };
+    while (count > 0)
+    {
+        std::ptrdiff_t half{ count / 2 };
+        if (!comp(value, first[half]))
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+const T* CustomArray<T, Allocator>::gallopLowerBound(const T* first, const T* last, const T& value, Compare comp)
+{
+    std::ptrdiff_t size{ last - first };
+    if (size == 0 || !comp(*first, value)) { return first; }
+
+    // first[bound / 2] is less than value at every step.
+    std::ptrdiff_t bound{ 1 };
+    while (bound < size && comp(first[bound], value))
+    {
+        bound *= 2;
+    }
+    return rangeLowerBound(first + bound / 2 + 1, first + ((bound < size) ? bound : size), value, comp);
+}
+
+template <typename T, typename Allocator>
+const CustomArray<T, Allocator>& CustomArray<T, Allocator>::sortedOrCopy(const CustomArray<T, Allocator>& array, CustomArray<T, Allocator>& copy,
+                                                   std::size_t threads)
+{
+    if (array.isSorted()) { return array; }
+
+    copy = array;
+    if (threads == 1)
+    {
+        copy.sort();
+    }
+    else
+    {
+        copy.parallelSort(threads);
+    }
+    return copy;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::multiwaySplit(T* data, const std::size_t* bounds, std::size_t ways,
+                                   std::size_t rank, std::size_t* positions, Compare comp)
+{
+    if (rank == 0 || rank >= bounds[ways] - bounds[0])
+    {
+        for (std::size_t way{ 0 }; way < ways; ++way)
+        {
+            positions[way] = (rank == 0) ? bounds[way] : bounds[way + 1];
+        }
+        return;
+    }
+
+    // The number of elements, across every range, that are less than value.
+    auto countLess = [data, bounds, ways, comp](const T& value)
+    {
+        std::size_t count{ 0 };
+        for (std::size_t way{ 0 }; way < ways; ++way)
+        {
+            T* first{ data + bounds[way] };
+            count += static_cast<std::size_t>(rangeLowerBound(first, data + bounds[way + 1], value, comp) - first);
+        }
+        return count;
+    };
+
+    // The element of the given rank is the largest element, in any range, with at most rank elements less than it.
+    T* selected{ nullptr };
+    for (std::size_t way{ 0 }; way < ways; ++way)
+    {
+        std::size_t low{ bounds[way] };
+        std::size_t high{ bounds[way + 1] };
+        while (low < high)
+        {
+            std::size_t middle{ low + (high - low) / 2 };
+            if (countLess(data[middle]) <= rank)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        if (low > bounds[way] && (selected == nullptr || comp(*selected, data[low - 1])))
+        {
+            selected = data + (low - 1);
+        }
+    }
+
+    std::size_t remaining{ rank };
+    for (std::size_t way{ 0 }; way < ways; ++way)
+    {
+        T* first{ data + bounds[way] };
+        positions[way] = static_cast<std::size_t>(rangeLowerBound(first, data + bounds[way + 1], *selected, comp) - data);
+        remaining -= positions[way] - bounds[way];
+    }
+    for (std::size_t way{ 0 }; way < ways && remaining > 0; ++way)
+    {
+        const T* upper{ rangeUpperBound(data + positions[way], data + bounds[way + 1], *selected, comp) };
+        std::size_t equal{ static_cast<std::size_t>(upper - (data + positions[way])) };
+        std::size_t taken{ (equal < remaining) ? equal : remaining };
+        positions[way] += taken;
+        remaining -= taken;
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::multiwayMerge(T** heads, T** tails, std::size_t ways, T* out, Compare comp)
+{
+    // Empty ranges are removed, so that every range in the heap has a first element.
+    std::size_t heapSize{ 0 };
+    for (std::size_t way{ 0 }; way < ways; ++way)
+    {
+        if (heads[way] != tails[way])
+        {
+            heads[heapSize] = heads[way];
+            tails[heapSize] = tails[way];
+            ++heapSize;
+        }
+    }
+
+    auto siftDown = [heads, tails, comp](std::size_t root, std::size_t length)
+    {
+        std::size_t child{ 2 * root + 1 };
+        while (child < length)
+        {
+            if (child + 1 < length && comp(*heads[child + 1], *heads[child])) { ++child; }
+            if (!comp(*heads[child], *heads[root])) { break; }
+            std::swap(heads[root], heads[child]);
+            std::swap(tails[root], tails[child]);
+            root = child;
+            child = 2 * root + 1;
+        }
+    };
+
+    for (std::size_t root{ heapSize / 2 }; root > 0; --root)
+    {
+        siftDown(root - 1, heapSize);
+    }
+    while (heapSize > 0)
+    {
+        *out++ = std::move(*heads[0]++);
+        if (heads[0] == tails[0])
+        {
+            --heapSize;
+            heads[0] = heads[heapSize];
+            tails[0] = tails[heapSize];
+        }
+        siftDown(0, heapSize);
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+void CustomArray<T, Allocator>::runParallel(std::size_t threads, Function function)
+{
+    // An exception thrown by a call is stored until every thread has been joined.
+    std::unique_ptr<std::exception_ptr[]> errors{ new std::exception_ptr[threads] };
+    std::exception_ptr* callErrors{ errors.get() };
+    auto call = [&function, callErrors](std::size_t index)
+    {
+        try
+        {
+            function(index);
+        }
+        catch (...)
+        {
+            callErrors[index] = std::current_exception();
+        }
+    };
+
+    std::unique_ptr<std::thread[]> workers{ new std::thread[threads] };
+    std::size_t started{ 1 };
+    try
+    {
+        for (; started < threads; ++started)
+        {
+            workers[started] = std::thread{ call, started };
+        }
+    }
+    catch (const std::system_error& e)
+    {
+        std::cerr << "Standard exception caught: " << e.what() << "\n"
+                  << "Running " << threads - started << " remaining tasks on the calling thread.\n";
+    }
+    for (std::size_t index{ started }; index < threads; ++index)
+    {
+        call(index);
+    }
+    call(0);
+    for (std::size_t index{ 1 }; index < started; ++index)
+    {
+        workers[index].join();
+    }
+    for (std::size_t index{ 0 }; index < threads; ++index)
+    {
+        if (callErrors[index])
+        {
+            std::rethrow_exception(callErrors[index]);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::parallelThreads(std::size_t threads, std::size_t elements, std::size_t grain)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads > elements / grain)
+    {
+        threads = elements / grain;
+    }
+    return (threads < 1) ? 1 : threads;
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+void CustomArray<T, Allocator>::parallelChunks(std::size_t length, std::size_t threads, Function function)
+{
+    runParallel(threads, [length, threads, &function](std::size_t chunk)
+    {
+        std::size_t first{ length / threads * chunk + ((chunk < length % threads) ? chunk : length % threads) };
+        std::size_t last{ length / threads * (chunk + 1) + ((chunk + 1 < length % threads) ? chunk + 1 : length % threads) };
+        function(chunk, first, last);
+    });
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::mergePathSplit(T* a, std::size_t aLength, T* b, std::size_t bLength, std::size_t diagonal)
+{
+    std::size_t low{ (diagonal > bLength) ? diagonal - bLength : 0 };
+    std::size_t high{ (diagonal < aLength) ? diagonal : aLength };
+    while (low < high)
+    {
+        // a[middle] is among the first diagonal elements if it is taken before b[diagonal - middle - 1].
+        std::size_t middle{ low + (high - low) / 2 };
+        if (a[middle] < b[diagonal - middle - 1])
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+template <typename T, typename Allocator>
+template <typename Output>
+void CustomArray<T, Allocator>::mergeRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out)
+{
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            out.put(*i++);
+        }
+        else
+        {
+            out.put(*j++);
+        }
+    }
+    for (; i != iEnd; ++i) { out.put(*i); }
+    for (; j != jEnd; ++j) { out.put(*j); }
+}
+
+template <typename T, typename Allocator>
+template <typename Output>
+void CustomArray<T, Allocator>::unionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out)
+{
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            out.put(*i++);
+        }
+        else if (*j < *i)
+        {
+            out.put(*j++);
+        }
+        else
+        {
+            out.put(*i++);
+            ++j;
+        }
+    }
+    for (; i != iEnd; ++i) { out.put(*i); }
+    for (; j != jEnd; ++j) { out.put(*j); }
+}
+
+template <typename T, typename Allocator>
+template <typename Output>
+void CustomArray<T, Allocator>::differenceRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out)
+{
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            out.put(*i++);
+        }
+        else if (*j < *i)
+        {
+            ++j;
+        }
+        else
+        {
+            ++i;
+            ++j;
+        }
+    }
+    for (; i != iEnd; ++i) { out.put(*i); }
+}
+
+template <typename T, typename Allocator>
+template <typename Output>
+void CustomArray<T, Allocator>::intersectionRanges(const T* i, const T* iEnd, const T* j, const T* jEnd, Output& out)
+{
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            ++i;
+        }
+        else if (*j < *i)
+        {
+            ++j;
+        }
+        else
+        {
+            out.put(*i++);
+            ++j;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Operation>
+CustomArray<T, Allocator> CustomArray<T, Allocator>::parallelSetOperation(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B,
+                                                    std::size_t threads, Operation operation)
+{
+    auto comp = [](const T& x, const T& y) { return x < y; };
+    threads = parallelThreads(threads, A.m_length + B.m_length);
+    CustomArray<T, Allocator> copyA{ A.m_allocator };
+    CustomArray<T, Allocator> copyB{ B.m_allocator };
+    const CustomArray<T, Allocator>& sortedA{ sortedOrCopy(A, copyA, threads) };
+    const CustomArray<T, Allocator>& sortedB{ sortedOrCopy(B, copyB, threads) };
+    T* a{ sortedA.m_array_ptr };
+    T* b{ sortedB.m_array_ptr };
+    std::size_t aLength{ sortedA.m_length };
+    std::size_t bLength{ sortedB.m_length };
+    std::size_t total{ aLength + bLength };
+
+    // Part t of the work is [aSplits[t], aSplits[t + 1]) of A and [bSplits[t], bSplits[t + 1]) of B.
+    std::unique_ptr<std::size_t[]> aSplits{ new std::size_t[threads + 1] };
+    std::unique_ptr<std::size_t[]> bSplits{ new std::size_t[threads + 1] };
+    for (std::size_t part{ 0 }; part <= threads; ++part)
+    {
+        std::size_t diagonal{ total / threads * part + ((part < total % threads) ? part : total % threads) };
+        std::size_t aSplit{ mergePathSplit(a, aLength, b, bLength, diagonal) };
+        std::size_t bSplit{ diagonal - aSplit };
+        if (aSplit < aLength || bSplit < bLength)
+        {
+            const T& next{ (aSplit < aLength && (bSplit == bLength || !(b[bSplit] < a[aSplit]))) ? a[aSplit] : b[bSplit] };
+            aSplit = static_cast<std::size_t>(rangeLowerBound(a, a + aSplit, next, comp) - a);
+            bSplit = static_cast<std::size_t>(rangeLowerBound(b, b + bSplit, next, comp) - b);
+        }
+        aSplits[part] = aSplit;
+        bSplits[part] = bSplit;
+    }
+
+    std::unique_ptr<std::size_t[]> offsets{ new std::size_t[threads + 1] };
+    std::size_t* partOffsets{ offsets.get() };
+    std::size_t* partA{ aSplits.get() };
+    std::size_t* partB{ bSplits.get() };
+    runParallel(threads, [a, b, partA, partB, partOffsets, operation](std::size_t part)
+    {
+        CountingOutput counter{ 0 };
+        operation(a + partA[part], a + partA[part + 1], b + partB[part], b + partB[part + 1], counter);
+        partOffsets[part + 1] = counter.m_count;
+    });
+    partOffsets[0] = 0;
+    for (std::size_t part{ 0 }; part < threads; ++part)
+    {
+        partOffsets[part + 1] += partOffsets[part];
+    }
+
+    CustomArray<T, Allocator> result{ parallelConstruct(A.selectAllocator(), partOffsets, threads,
+        [a, b, partA, partB, operation](std::size_t part, PointerOutput& writer)
+        {
+            operation(a + partA[part], a + partA[part + 1], b + partB[part], b + partB[part + 1], writer);
+        }) };
+    result.m_sort_state = SortState::ascending;
+    return result;
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+CustomArray<T, Allocator> CustomArray<T, Allocator>::parallelConstruct(const Allocator& allocator, const std::size_t* offsets,
+                                                                      std::size_t threads, Function function)
+{
+    CustomArray<T, Allocator> result{ allocator };
+    std::size_t length{ offsets[threads] };
+    if (length == 0) { return result; }
+
+    // constructed[t] is the number of elements part t has constructed, so they can be destroyed if any part throws.
+    std::unique_ptr<std::size_t[]> counts{ new std::size_t[threads]() };
+    std::size_t* constructed{ counts.get() };
+    T* buffer{ result.allocateBuffer(length) };
+    try
+    {
+        runParallel(threads, [buffer, offsets, constructed, &result, &function](std::size_t part)
+        {
+            PointerOutput writer{ result.m_allocator, buffer + offsets[part] };
+            try
+            {
+                function(part, writer);
+            }
+            catch (...)
+            {
+                constructed[part] = static_cast<std::size_t>(writer.m_ptr - (buffer + offsets[part]));
+                throw;
+            }
+            constructed[part] = offsets[part + 1] - offsets[part];
+        });
+    }
+    catch (...)
+    {
+        for (std::size_t part{ 0 }; part < threads; ++part)
+        {
+            result.destroyRange(buffer + offsets[part], buffer + offsets[part] + constructed[part]);
+        }
+        result.deallocateBuffer(buffer, length);
+        throw;
+    }
+    result.m_array_ptr = buffer;
+    result.m_capacity = length;
+    result.m_length = length;
+    return result;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::unionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result)
+{
+    std::size_t aLength{ static_cast<std::size_t>(iEnd - i) };
+    std::size_t bLength{ static_cast<std::size_t>(jEnd - j) };
+    result.reserve(aLength + bLength);
+    auto comp = [](const T& a, const T& b) { return a < b; };
+
+    if (aLength * gallopRatio <= bLength || bLength * gallopRatio <= aLength)
+    {
+        // Walk the shorter array, copying the run of the longer array before each of its elements.
+        bool aShorter{ aLength <= bLength };
+        const T* small{ aShorter ? i : j };
+        const T* smallEnd{ aShorter ? iEnd : jEnd };
+        const T* large{ aShorter ? j : i };
+        const T* largeEnd{ aShorter ? jEnd : iEnd };
+        for (; small != smallEnd; ++small)
+        {
+            const T* bound{ gallopLowerBound(large, largeEnd, *small, comp) };
+            for (; large != bound; ++large) { result.pushBack(*large); }
+            result.pushBack(*small);
+            if (large != largeEnd && !(*small < *large)) { ++large; }
+        }
+        for (; large != largeEnd; ++large) { result.pushBack(*large); }
+        return;
+    }
+
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            result.pushBack(*i);
+            ++i;
+        }
+        else if (*i > *j)
+        {
+            result.pushBack(*j);
+            ++j;
+        }
+        else if (*i == *j)
+        {
+            result.pushBack(*i);
+            ++i;
+            ++j;
+        }
+    }
+    for (; i != iEnd; ++i) { result.pushBack(*i); }
+    for (; j != jEnd; ++j) { result.pushBack(*j); }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::differenceSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result)
+{
+    std::size_t aLength{ static_cast<std::size_t>(iEnd - i) };
+    std::size_t bLength{ static_cast<std::size_t>(jEnd - j) };
+    result.reserve(aLength);
+    auto comp = [](const T& a, const T& b) { return a < b; };
+
+    if (aLength * gallopRatio <= bLength)
+    {
+        // Find each element of A in B, skipping the elements of B before it.
+        for (; i != iEnd; ++i)
+        {
+            j = gallopLowerBound(j, jEnd, *i, comp);
+            if (j != jEnd && !(*i < *j))
+            {
+                ++j;
+            }
+            else
+            {
+                result.pushBack(*i);
+            }
+        }
+        return;
+    }
+
+    if (bLength * gallopRatio <= aLength)
+    {
+        // Find each element of B in A, copying the run of A before it.
+        for (; j != jEnd; ++j)
+        {
+            const T* bound{ gallopLowerBound(i, iEnd, *j, comp) };
+            for (; i != bound; ++i) { result.pushBack(*i); }
+            if (i != iEnd && !(*j < *i)) { ++i; }
+        }
+        for (; i != iEnd; ++i) { result.pushBack(*i); }
+        return;
+    }
+
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            result.pushBack(*i);
+            ++i;
+        }
+        else if (*i > *j)
+        {
+            ++j;
+        }
+        else if (*i == *j)
+        {
+            ++i;
+            ++j;
+        }
+    }
+    for (; i != iEnd; ++i) { result.pushBack(*i); }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::intersectionSorted(const T* i, const T* iEnd, const T* j, const T* jEnd, CustomArray<T, Allocator>& result)
+{
+    std::size_t aLength{ static_cast<std::size_t>(iEnd - i) };
+    std::size_t bLength{ static_cast<std::size_t>(jEnd - j) };
+    result.reserve((aLength < bLength) ? aLength : bLength);
+    auto comp = [](const T& a, const T& b) { return a < b; };
+
+    if (aLength * gallopRatio <= bLength || bLength * gallopRatio <= aLength)
+    {
+        // Find each element of the shorter array in the longer one.
+        bool aShorter{ aLength <= bLength };
+        const T* small{ aShorter ? i : j };
+        const T* smallEnd{ aShorter ? iEnd : jEnd };
+        const T* large{ aShorter ? j : i };
+        const T* largeEnd{ aShorter ? jEnd : iEnd };
+        for (; small != smallEnd && large != largeEnd; ++small)
+        {
+            large = gallopLowerBound(large, largeEnd, *small, comp);
+            if (large != largeEnd && !(*small < *large))
+            {
+                result.pushBack(*small);
+                ++large;
+            }
+        }
+        return;
+    }
+
+    while (i != iEnd && j != jEnd)
+    {
+        if (*i < *j)
+        {
+            ++i;
+        }
+        else if (*i > *j)
+        {
+            ++j;
+        }
+        else if (*i == *j)
+        {
+            result.pushBack(*i);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::SumType CustomArray<T, Allocator>::sumRange(const T* data, std::size_t length, std::size_t threads)
+{
+    threads = parallelThreads(threads, length, parallelReduceGrain);
+    if (threads == 1) { return simdSum(data, length); }
+
+    std::unique_ptr<SumType[]> partial{ new SumType[threads] };
+    SumType* partialSums{ partial.get() };
+    parallelChunks(length, threads, [data, partialSums](std::size_t chunk, std::size_t first, std::size_t last)
+    {
+        partialSums[chunk] = simdSum(data + first, last - first);
+    });
+    SumType sum{};
+    for (std::size_t chunk{ 0 }; chunk < threads; ++chunk)
+    {
+        sum += partialSums[chunk];
+    }
+    return sum;
+}
 
-template <typename T>
-CustomArray<T>::CustomArray(CustomArray<T>&& other) noexcept
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::SumType CustomArray<T, Allocator>::dotRange(const T* a, const T* b, std::size_t length, std::size_t threads)
+{
+    threads = parallelThreads(threads, length, parallelReduceGrain);
+    if (threads == 1) { return simdDot(a, b, length); }
+
+    std::unique_ptr<SumType[]> partial{ new SumType[threads] };
+    SumType* partialSums{ partial.get() };
+    parallelChunks(length, threads, [a, b, partialSums](std::size_t chunk, std::size_t first, std::size_t last)
+    {
+        partialSums[chunk] = simdDot(a + first, b + first, last - first);
+    });
+    SumType sum{};
+    for (std::size_t chunk{ 0 }; chunk < threads; ++chunk)
+    {
+        sum += partialSums[chunk];
+    }
+    return sum;
+}
+
+template <typename T, typename Allocator>
+std::pair<T, T> CustomArray<T, Allocator>::minMaxRange(const T* data, std::size_t length, std::size_t threads)
+{
+    if (length == 0) { return std::pair<T, T>{}; }
+
+    std::pair<T, T> result{ data[0], data[0] };
+    threads = parallelThreads(threads, length, parallelReduceGrain);
+    if (threads == 1)
+    {
+        simdMinMax(data, length, result.first, result.second);
+        return result;
+    }
+
+    std::unique_ptr<std::pair<T, T>[]> partial{ new std::pair<T, T>[threads] };
+    std::pair<T, T>* partialResults{ partial.get() };
+    parallelChunks(length, threads, [data, partialResults](std::size_t chunk, std::size_t first, std::size_t last)
+    {
+        simdMinMax(data + first, last - first, partialResults[chunk].first, partialResults[chunk].second);
+    });
+    for (std::size_t chunk{ 0 }; chunk < threads; ++chunk)
+    {
+        if (partialResults[chunk].first < result.first) { result.first = partialResults[chunk].first; }
+        if (result.second < partialResults[chunk].second) { result.second = partialResults[chunk].second; }
+    }
+    return result;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::fillRange(T* data, std::size_t length, const T& value, std::size_t threads)
+{
+    threads = parallelThreads(threads, length, parallelReduceGrain);
+    if (threads == 1)
+    {
+        simdFill(data, length, value);
+        return;
+    }
+    parallelChunks(length, threads, [data, &value](std::size_t, std::size_t first, std::size_t last)
+    {
+        simdFill(data + first, last - first, value);
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+void CustomArray<T, Allocator>::transformRange(T* data, std::size_t length, Function function, std::size_t threads)
+{
+    threads = parallelThreads(threads, length, parallelReduceGrain);
+    if (threads == 1)
+    {
+        simdTransform(data, length, function);
+        return;
+    }
+    parallelChunks(length, threads, [data, &function](std::size_t, std::size_t first, std::size_t last)
+    {
+        simdTransform(data + first, last - first, function);
+    });
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray() noexcept
+{
+    std::cout << "CustomArray default constructor called.\n";
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray(const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomArray (allocator) constructor called.\n";
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray(std::initializer_list<T> elements, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomArray list-initialised constructor called.\n" ;
+    if (elements.size() > 0)
+    {
+        m_length = elements.size();
+        m_capacity = elements.size();
+        m_sort_state = SortState::unknown;
+        m_array_ptr = allocateBuffer(elements.size());
+        constructCopies(elements.begin(), elements.end(), m_array_ptr);
+    }
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray(const CustomArray<T, Allocator>& other) noexcept
+    : m_allocator{ other.selectAllocator() }
+{
+    std::cout << "CustomArray copy constructor called.\n";
+    deepCopy(other);
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray(const CustomArray<T, Allocator>& other, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomArray (allocator) copy constructor called.\n";
+    deepCopy(other);
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::CustomArray(CustomArray<T, Allocator>&& other) noexcept
+    : m_allocator{ std::move(other.m_allocator) }
 {
     std::cout << "CustomArray move constructor called.\n";
-    if (other.m_length > 0)
+    if (!other.isNull())
     {
         m_length = other.m_length;
+        m_capacity = other.m_capacity;
+        m_front = other.m_front;
+        m_sort_state = other.m_sort_state;
         m_array_ptr = other.m_array_ptr;
         other.m_length = 0;
+        other.m_capacity = 0;
+        other.m_front = 0;
+        other.m_sort_state = SortState::ascending;
+        ++other.m_revision;
         other.m_array_ptr = nullptr;
     }
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <typename InputIterator>
-CustomArray<T>::CustomArray(InputIterator first, InputIterator last) noexcept
+CustomArray<T, Allocator>::CustomArray(InputIterator first, InputIterator last, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
 {
     std::cout << "CustomLinkedList (iterator) copy constructor called.\n";
-    while (first != last)
-    {
-        pushBack(*first);
-        ++first;
-    }
+    insert(0, first, last);
 }
 
-template <typename T>
-CustomArray<T>::~CustomArray() noexcept
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>::~CustomArray() noexcept
 {
     std::cout << "CustomArray destructor called.\n";
     clear();
@@ -997,8 +4368,8 @@ CustomArray<T>::~CustomArray() noexcept
 
 // Operator overload definitions begin here.
 
-template <typename T>
-T& CustomArray<T>::operator[](int position)
+template <typename T, typename Allocator>
+T& CustomArray<T, Allocator>::operator[](int position)
 {
     if (position < 0)
     {
@@ -1014,361 +4385,884 @@ T& CustomArray<T>::operator[](int position)
     return m_array_ptr[position];
 }
 
-template <typename T>
-const T& CustomArray<T>::operator[](int position) const
+template <typename T, typename Allocator>
+const T& CustomArray<T, Allocator>::operator[](int position) const
 {
     if (position < 0)
     {
         position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
         return m_array_ptr[position];
     }
-
-    if (position > static_cast<int>(m_length))
+
+    if (position > static_cast<int>(m_length))
+    {
+        return m_array_ptr[m_length];
+    }
+
+    return m_array_ptr[position];
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>& CustomArray<T, Allocator>::operator=(const CustomArray<T, Allocator>& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    propagateAllocator(other, typename AllocTraits::propagate_on_container_copy_assignment{});
+    deepCopy(other);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>& CustomArray<T, Allocator>::operator=(CustomArray<T, Allocator>&& other)
+{
+    if (AllocTraits::propagate_on_container_move_assignment::value || m_allocator == other.m_allocator)
+    {
+        swapAllocator(other, typename AllocTraits::propagate_on_container_move_assignment{});
+        swapData(other);
+        return *this;
+    }
+
+    // The memory of other cannot be freed by this array's allocator, so its elements are moved instead.
+    clear();
+    reserve(other.m_length);
+    constructMoves(other.m_array_ptr, other.m_array_ptr + other.m_length, m_array_ptr);
+    m_length = other.m_length;
+    m_sort_state = other.m_sort_state;
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator>& CustomArray<T, Allocator>::operator=(std::initializer_list<T> elements)
+{
+    CustomArray<T, Allocator> temp{ elements, m_allocator };
+    swap(temp);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::clear()
+{
+    if (!isNull())
+    {
+        destroyRange(m_array_ptr, m_array_ptr + m_length);
+        deallocateBuffer(m_array_ptr - m_front, m_capacity);
+    }
+    m_length = 0;
+    m_capacity = 0;
+    m_front = 0;
+    m_sort_state = SortState::ascending;
+    ++m_revision;
+    m_array_ptr = nullptr;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::reserve(std::size_t capacity)
+{
+    if (capacity > m_capacity - m_front)
+    {
+        reallocate(capacity);
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::shrinkToFit()
+{
+    if (m_capacity == m_length) { return; }
+
+    if (empty())
+    {
+        clear();
+        return;
+    }
+
+    reallocate(m_length);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::resize(std::size_t length)
+{
+    if (m_length == length) { return; }
+
+    try
+    {
+        if (length > m_capacity - m_front)
+        {
+            reallocate(length);
+        }
+        if (length > m_length)
+        {
+            constructValues(m_array_ptr + m_length, m_array_ptr + length);
+            std::size_t position{ m_length };
+            m_length = length;
+            recordInsertRange(position, length - position);
+        }
+        else
+        {
+            recordErase();
+            destroyRange(m_array_ptr + length, m_array_ptr + m_length);
+            m_length = length;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Standard exception caught: " << e.what() << "\n"
+                  << "Length of array remains " << size() << "\n";
+        return;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::insert(int position, const T& value)
+{
+    emplace(position, value);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CustomArray<T, Allocator>::emplace(int position, Args&&... args)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+        emplace(position, std::forward<Args>(args)...);
+        return;
+    }
+
+    if (position > static_cast<int>(m_length))
+    {
+        emplace(static_cast<int>(m_length), std::forward<Args>(args)...);
+        return;
+    }
+
+    if (m_front + m_length == m_capacity && m_front <= m_length)
+    {
+        // args may refer to an element of this array, so the element is constructed before the old memory is deleted.
+        std::size_t new_capacity{ nextCapacity(m_length + 1) };
+        T* new_array_ptr { allocateBuffer(new_capacity) };
+        T* inserted_ptr{ new_array_ptr + position };
+        try
+        {
+            AllocTraits::construct(m_allocator, inserted_ptr, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocateBuffer(new_array_ptr, new_capacity);
+            throw;
+        }
+        recordInsert(position, *inserted_ptr);
+        try
+        {
+            constructMoves(m_array_ptr, m_array_ptr + position, new_array_ptr);
+            try
+            {
+                constructMoves(m_array_ptr + position, m_array_ptr + m_length, inserted_ptr + 1);
+            }
+            catch (...)
+            {
+                destroyRange(new_array_ptr, inserted_ptr);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            destroyRange(inserted_ptr, inserted_ptr + 1);
+            deallocateBuffer(new_array_ptr, new_capacity);
+            throw;
+        }
+        if (!isNull())
+        {
+            destroyRange(m_array_ptr, m_array_ptr + m_length);
+            deallocateBuffer(m_array_ptr - m_front, m_capacity);
+        }
+        m_array_ptr = new_array_ptr;
+        new_array_ptr = nullptr;
+        m_capacity = new_capacity;
+        m_front = 0;
+        ++m_length;
+        return;
+    }
+
+    if (position == static_cast<int>(m_length) && m_front + m_length < m_capacity)
+    {
+        AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::forward<Args>(args)...);
+        recordInsert(position, m_array_ptr[m_length]);
+        ++m_length;
+        return;
+    }
+
+    // args may refer to an element of this array, so the element is constructed before any data is moved.
+    T temp(std::forward<Args>(args)...);
+    recordInsert(position, temp);
+    if (m_front + m_length == m_capacity)
+    {
+        // More unused elements are before the array than in it, so they are reclaimed instead of reallocating.
+        shiftData(0);
+    }
+    if (position == static_cast<int>(m_length))
+    {
+        AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(temp));
+        ++m_length;
+        return;
+    }
+
+    // The last element is moved into the unused memory after it, and the others are moved along by assignment.
+    AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(m_array_ptr[m_length - 1]));
+    ++m_length;
+    for (int after{ static_cast<int>(m_length) - 2 }; after > position; --after)
+    {
+        m_array_ptr[after] = std::move(m_array_ptr[after - 1]);
+    }
+    m_array_ptr[position] = std::move(temp);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::erase(int position)
+{
+    if (empty()) { return; }
+
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+        erase(position);
+        return;
+    }
+
+    if (position >= static_cast<int>(m_length))
+    {
+        erase(static_cast<int>(m_length) - 1);
+        return;
+    }
+
+    for (int after{ position + 1 }; after < static_cast<int>(m_length); ++after)
+    {
+        m_array_ptr[after - 1] = std::move(m_array_ptr[after]);
+    }
+    --m_length;
+    AllocTraits::destroy(m_allocator, m_array_ptr + m_length);
+    recordErase();
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator, typename>
+void CustomArray<T, Allocator>::insert(int position, InputIterator first, InputIterator last)
+{
+    insertRange(clampPosition(position), first, last, decltype(isMultiPass<InputIterator>(0)){});
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::insert(int position, std::size_t count, const T& value)
+{
+    if (count == 0) { return; }
+
+    // value may refer to an element of this array, so it is copied before any data is moved.
+    T temp(value);
+    insertGap(clampPosition(position), count, [this, &temp, count](T* destination)
+    {
+        constructFill(destination, count, temp);
+    });
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::erase(int first, int last)
+{
+    std::size_t begin{ clampPosition(first) };
+    std::size_t end{ clampPosition(last) };
+    if (begin >= end) { return; }
+
+    T* destination{ m_array_ptr + begin };
+    for (T* source{ m_array_ptr + end }; source != m_array_ptr + m_length; ++source, ++destination)
+    {
+        *destination = std::move(*source);
+    }
+    destroyRange(destination, m_array_ptr + m_length);
+    m_length -= end - begin;
+    recordErase();
+}
+
+template <typename T, typename Allocator>
+template <typename Predicate>
+std::size_t CustomArray<T, Allocator>::eraseIf(Predicate pred)
+{
+    T* kept_ptr{ m_array_ptr };
+    T* end_ptr{ m_array_ptr + m_length };
+    for (T* current{ m_array_ptr }; current != end_ptr; ++current)
+    {
+        if (!pred(*current))
+        {
+            if (kept_ptr != current)
+            {
+                *kept_ptr = std::move(*current);
+            }
+            ++kept_ptr;
+        }
+    }
+    std::size_t removed{ static_cast<std::size_t>(end_ptr - kept_ptr) };
+    destroyRange(kept_ptr, end_ptr);
+    m_length -= removed;
+    if (removed > 0) { recordErase(); }
+    return removed;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::pushBack(const T& value)
+{
+    insert(static_cast<int>(m_length),value);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::pushBack(T&& value)
+{
+    emplace(static_cast<int>(m_length), std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CustomArray<T, Allocator>::emplaceBack(Args&&... args)
+{
+    emplace(static_cast<int>(m_length), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::pushFront(const T& value)
+{
+    recordInsert(0, value);
+
+    if (m_front > 0)
+    {
+        AllocTraits::construct(m_allocator, m_array_ptr - 1, value);
+        --m_array_ptr;
+        --m_front;
+        ++m_length;
+        return;
+    }
+
+    // value may refer to an element of this array, so it is copied before any data is moved.
+    T temp{ value };
+    std::size_t back{ m_capacity - m_length };
+    if (back > m_length)
+    {
+        shiftData((back + 1) / 2);
+    }
+    else
     {
-        return m_array_ptr[m_length];
+        std::size_t new_capacity{ nextCapacity(m_length + 1) };
+        reallocate(new_capacity, (new_capacity - m_length + 1) / 2);
     }
+    AllocTraits::construct(m_allocator, m_array_ptr - 1, std::move(temp));
+    --m_array_ptr;
+    --m_front;
+    ++m_length;
+}
 
-    return m_array_ptr[position];
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::popBack()
+{
+    erase(static_cast<int>(m_length));
 }
 
-template <typename T>
-CustomArray<T>& CustomArray<T>::operator=(const CustomArray<T>& other)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::popFront()
 {
-    clear();
-    deepCopy(other);
-    return *this;
+    if (empty()) { return; }
+
+    AllocTraits::destroy(m_allocator, m_array_ptr);
+    ++m_array_ptr;
+    ++m_front;
+    --m_length;
+    recordErase();
 }
 
-template <typename T>
-CustomArray<T>& CustomArray<T>::operator=(CustomArray<T>&& other)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::reverse()
 {
-    swap(other);
-    return *this;
+    invalidate();
+    auto forward_it{ begin() };
+    auto backward_it{ m_array_ptr + m_length  - 1 };
+    do
+    {
+        std::swap(*forward_it,*backward_it);
+        ++forward_it;
+        --backward_it;
+    }
+    while (forward_it != backward_it);
 }
 
-template <typename T>
-CustomArray<T>& CustomArray<T>::operator=(std::initializer_list<T> elements)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::sort()
 {
-    CustomArray<T> temp{ elements };
-    swap(temp);
-    return *this;
+    sort([](const T& a, const T& b) { return a < b; });
+    m_sort_state = SortState::ascending;
 }
 
-// Operator overload definitions end here.
+template <typename T, typename Allocator>
+template <typename Compare>
+void CustomArray<T, Allocator>::sort(Compare comp)
+{
+    if (m_length < 2) { return; }
 
-// Public member functions definitions begin here.
+    // badAllowed is log2(n), the number of unbalanced partitions tolerated before falling back to heapSort.
+    int badAllowed{ 0 };
+    for (std::size_t length{ m_length }; length > 1; length >>= 1)
+    {
+        ++badAllowed;
+    }
+    pdqSort(m_array_ptr, m_array_ptr + m_length, comp, badAllowed, true);
+    m_sort_state = SortState::unknown;
+    ++m_revision;
+}
 
-template <typename T>
-void CustomArray<T>::clear()
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::bubbleSort()
 {
-    m_length = 0;
-    if (!isNull()) { delete[] m_array_ptr; }
-    m_array_ptr = nullptr;
+    sort();
 }
 
-template <typename T>
-void CustomArray<T>::resize(std::size_t length)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::radixSort()
 {
-    if (m_length == length) { return; }
+    static_assert(std::is_integral<T>::value || std::is_floating_point<T>::value,
+                  "radixSort requires an integral or floating point element type.");
+    static_assert(!std::is_floating_point<T>::value || std::numeric_limits<T>::is_iec559,
+                  "radixSort requires IEEE 754 floating point numbers.");
+    static_assert(sizeof(T) <= sizeof(std::uint64_t), "radixSort supports element types up to 64 bits wide.");
 
-    try
+    if (m_length < radixSortThreshold)
+    {
+        sort();
+        return;
+    }
+
+    std::size_t counts[sizeof(T)][256]{};
+    for (std::size_t position{ 0 }; position < m_length; ++position)
     {
-        T* new_array_ptr { new T[length]{} };
-        auto elementsToCopy{ (length > m_length) ? m_length : length };
-        for (auto position{ 0 }; position < static_cast<int>(elementsToCopy); ++position)
+        RadixKey key{ radixKey(m_array_ptr[position]) };
+        for (std::size_t byte{ 0 }; byte < sizeof(T); ++byte)
         {
-            new_array_ptr[position] = m_array_ptr[position];
+            ++counts[byte][(key >> (byte * 8)) & 0xFF];
         }
-        delete[] m_array_ptr;
-        m_array_ptr = new_array_ptr;
-        m_length = length;
     }
-    catch (const std::exception& e)
+
+    T* scratch_ptr{ allocateBuffer(m_length) };
+    T* source{ m_array_ptr };
+    T* destination{ scratch_ptr };
+    for (std::size_t byte{ 0 }; byte < sizeof(T); ++byte)
     {
-        std::cerr << "Standard exception caught: " << e.what() << "\n"
-                  << "Length of array remains " << size() << "\n";
-        return;
+        std::size_t shift{ byte * 8 };
+        if (counts[byte][(radixKey(source[0]) >> shift) & 0xFF] == m_length) { continue; }
+
+        std::size_t offsets[256];
+        std::size_t total{ 0 };
+        for (std::size_t digit{ 0 }; digit < 256; ++digit)
+        {
+            offsets[digit] = total;
+            total += counts[byte][digit];
+        }
+        for (std::size_t position{ 0 }; position < m_length; ++position)
+        {
+            destination[offsets[(radixKey(source[position]) >> shift) & 0xFF]++] = source[position];
+        }
+        std::swap(source, destination);
     }
+
+    if (source != m_array_ptr)
+    {
+        std::memcpy(m_array_ptr, source, m_length * sizeof(T));
+    }
+    deallocateBuffer(scratch_ptr, m_length);
+    m_sort_state = SortState::ascending;
+    ++m_revision;
 }
 
-template <typename T>
-void CustomArray<T>::insert(int position, const T& value)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::parallelSort(std::size_t threads)
 {
-    if (position < 0)
+    threads = parallelThreads(threads, m_length);
+    if (threads < 2)
     {
-        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
-        insert(position, value);
+        sort();
         return;
     }
 
-    if (position > static_cast<int>(m_length))
+    auto comp = [](const T& a, const T& b) { return a < b; };
+
+    // Chunk i is [bounds[i], bounds[i + 1]). Each thread also merges the output range of the same size.
+    std::unique_ptr<std::size_t[]> bounds{ new std::size_t[threads + 1] };
+    for (std::size_t chunk{ 0 }; chunk <= threads; ++chunk)
     {
-        insert(static_cast<int>(m_length), value);
-        return;
+        bounds[chunk] = m_length / threads * chunk + ((chunk < m_length % threads) ? chunk : m_length % threads);
     }
 
-    T* new_array_ptr { new T[m_length + 1] };
-    if (!isNull())
+    T* data{ m_array_ptr };
+    std::size_t* chunkBounds{ bounds.get() };
+    runParallel(threads, [data, chunkBounds, comp](std::size_t chunk)
+    {
+        std::size_t length{ chunkBounds[chunk + 1] - chunkBounds[chunk] };
+        int badAllowed{ 0 };
+        for (; length > 1; length >>= 1)
+        {
+            ++badAllowed;
+        }
+        pdqSort(data + chunkBounds[chunk], data + chunkBounds[chunk + 1], comp, badAllowed, true);
+    });
+
+    // multiwayMerge assigns to the scratch elements, so they are constructed first unless T is trivial.
+    T* scratch_ptr{ allocateBuffer(m_length) };
+    if (!std::is_trivial<T>::value)
     {
-        for (int before{ 0 }; before < position; ++before)
+        try
         {
-            new_array_ptr[before] = m_array_ptr[before];
+            constructValues(scratch_ptr, scratch_ptr + m_length);
         }
-        for (int after{ position }; after < static_cast<int>(m_length); ++after)
+        catch (...)
         {
-            new_array_ptr[after + 1] = m_array_ptr[after];
+            deallocateBuffer(scratch_ptr, m_length);
+            throw;
         }
-        delete[] m_array_ptr;
     }
-    new_array_ptr[position] = value;
-    m_array_ptr = new_array_ptr;
-    new_array_ptr = nullptr;
-    ++m_length;
-}
 
-template <typename T>
-void CustomArray<T>::erase(int position)
-{
-    if (empty()) { return; }
+    // If a comparison or move throws, the scratch buffer is released and the elements keep valid but unspecified values.
+    try
+    {
+        // Row r of splits holds where rank chunkBounds[r] splits each sorted chunk. Every row is found before any
+        // thread merges, because the merge moves elements out of data while multiwaySplit would still be reading them.
+        std::unique_ptr<std::size_t[]> splitRows{ new std::size_t[(threads + 1) * threads] };
+        std::size_t* splits{ splitRows.get() };
+        multiwaySplit(data, chunkBounds, threads, 0, splits, comp);
+        runParallel(threads, [data, chunkBounds, threads, splits, comp](std::size_t part)
+        {
+            multiwaySplit(data, chunkBounds, threads, chunkBounds[part + 1], splits + (part + 1) * threads, comp);
+        });
+
+        runParallel(threads, [data, chunkBounds, threads, splits, scratch_ptr, comp](std::size_t part)
+        {
+            const std::size_t* firsts{ splits + part * threads };
+            const std::size_t* lasts{ splits + (part + 1) * threads };
+
+            std::unique_ptr<T*[]> heads{ new T*[threads] };
+            std::unique_ptr<T*[]> tails{ new T*[threads] };
+            for (std::size_t chunk{ 0 }; chunk < threads; ++chunk)
+            {
+                heads[chunk] = data + firsts[chunk];
+                tails[chunk] = data + lasts[chunk];
+            }
+            multiwayMerge(heads.get(), tails.get(), threads, scratch_ptr + chunkBounds[part], comp);
+        });
 
-    if (m_length == 1)
+        runParallel(threads, [data, chunkBounds, scratch_ptr](std::size_t part)
+        {
+            for (std::size_t position{ chunkBounds[part] }; position < chunkBounds[part + 1]; ++position)
+            {
+                data[position] = std::move(scratch_ptr[position]);
+            }
+        });
+    }
+    catch (...)
     {
-        clear();
-        return;
+        if (!std::is_trivial<T>::value)
+        {
+            destroyRange(scratch_ptr, scratch_ptr + m_length);
+        }
+        deallocateBuffer(scratch_ptr, m_length);
+        invalidate();
+        throw;
     }
-
-    if (position < 0)
+    if (!std::is_trivial<T>::value)
     {
-        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
-        erase(position);
-        return;
+        destroyRange(scratch_ptr, scratch_ptr + m_length);
     }
+    deallocateBuffer(scratch_ptr, m_length);
+    m_sort_state = SortState::ascending;
+    ++m_revision;
+}
 
-    if (position > static_cast<int>(m_length))
+template <typename T, typename Allocator>
+bool CustomArray<T, Allocator>::isSorted() const
+{
+    if (m_sort_state != SortState::unknown)
     {
-        erase(static_cast<int>(m_length));
-        return;
+        return m_sort_state == SortState::ascending;
     }
 
-    T* new_array_ptr { new T[m_length - 1] };
-    for (int before{ 0 }; before < position; ++before)
+    for (int i{ 0 }; i < static_cast<int>(m_length) - 1; ++i)
     {
-        new_array_ptr[before] = m_array_ptr[before];
+        if (m_array_ptr[i] > m_array_ptr[i + 1])
+        {
+            m_sort_state = SortState::unsorted;
+            return 0;
+        }
     }
-    for (int after{ position + 1 }; after < m_length; ++after)
+    m_sort_state = SortState::ascending;
+    return 1;
+}
+
+template <typename T, typename Allocator>
+int CustomArray<T, Allocator>::search(const T& value)
+{
+    if (!mayContain(value)) { return -1; }
+
+    if (isSorted())
     {
-        new_array_ptr[after - 1] = m_array_ptr[after];
+        return binarySearch(value);
     }
-    delete[] m_array_ptr;
-    m_array_ptr = new_array_ptr;
-    new_array_ptr = nullptr;
-    --m_length;
+    return linearSearch(value);
 }
 
-template <typename T>
-void CustomArray<T>::pushBack(const T& value)
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::count(const T& value) const
 {
-    insert(static_cast<int>(m_length),value);
+    if (!mayContain(value)) { return 0; }
+
+    return simdCount(m_array_ptr, m_length, value);
 }
 
-template <typename T>
-void CustomArray<T>::pushFront(const T& value)
+template <typename T, typename Allocator>
+CustomArray<int> CustomArray<T, Allocator>::findAll(const T& value) const
 {
-    insert(0,value);
+    CustomArray<int> indexes{};
+    if (!mayContain(value)) { return indexes; }
+
+    std::size_t index{ simdFind(m_array_ptr, m_length, value) };
+    while (index < m_length)
+    {
+        indexes.pushBack(static_cast<int>(index));
+        ++index;
+        index += simdFind(m_array_ptr + index, m_length - index, value);
+    }
+    return indexes;
 }
 
-template <typename T>
-void CustomArray<T>::popBack()
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::lowerBound(const T& value) const
 {
-    erase(static_cast<int>(m_length));
+    assert(isSorted() && "Array elements must be in ascending order.");
+    return branchlessBound(m_array_ptr, m_length, [&value](const T& element) { return element < value; });
 }
 
-template <typename T>
-void CustomArray<T>::popFront()
+template <typename T, typename Allocator>
+std::size_t CustomArray<T, Allocator>::upperBound(const T& value) const
 {
-    erase(0);
+    assert(isSorted() && "Array elements must be in ascending order.");
+    return branchlessBound(m_array_ptr, m_length, [&value](const T& element) { return !(value < element); });
 }
 
-template <typename T>
-void CustomArray<T>::reverse()
+template <typename T, typename Allocator>
+std::pair<std::size_t, std::size_t> CustomArray<T, Allocator>::equalRange(const T& value) const
 {
-    auto forward_it{ begin() };
-    auto backward_it{ m_array_ptr + m_length  - 1 };
-    do
-    {
-        std::swap(*forward_it,*backward_it);
-        ++forward_it;
-        --backward_it;
-    }
-    while (forward_it != backward_it);
+    std::size_t lower{ lowerBound(value) };
+    std::size_t upper{ lower + branchlessBound(m_array_ptr + lower, m_length - lower,
+                                               [&value](const T& element) { return !(value < element); }) };
+    return std::pair<std::size_t, std::size_t>{ lower, upper };
 }
 
-template <typename T>
-void CustomArray<T>::bubbleSort()
+template <typename T, typename Allocator>
+CustomArray<int> CustomArray<T, Allocator>::searchMany(const CustomArray<T, Allocator>& keys)
 {
-    for (int i{ 0 }; i < static_cast<int>(m_length) - 1; ++i)
+    CustomArray<int> indexes{};
+    indexes.reserve(keys.m_length);
+    if (!isSorted())
     {
-        for (int j{ 0 }; j < static_cast<int>(m_length) - 1 - i; ++j)
+        for (std::size_t i{}; i < keys.m_length; ++i)
         {
-            if (m_array_ptr[j] > m_array_ptr[j + 1])
-            {
-                std::swap(m_array_ptr[j],m_array_ptr[j + 1]);
-            }
+            indexes.pushBack(mayContain(keys.m_array_ptr[i]) ? linearSearch(keys.m_array_ptr[i]) : -1);
         }
+        return indexes;
     }
-}
 
-template <typename T>
-bool CustomArray<T>::isSorted()
-{
-    for (int i{ 0 }; i < static_cast<int>(m_length) - 1; ++i)
+    std::unique_ptr<std::size_t[]> bounds{ new std::size_t[keys.m_length] };
+    interleavedLowerBounds(m_array_ptr, m_length, keys.m_array_ptr, keys.m_length, bounds.get());
+    for (std::size_t i{}; i < keys.m_length; ++i)
     {
-        if (m_array_ptr[i] > m_array_ptr[i + 1])
-        {
-            return 0;
-        }
+        std::size_t index{ bounds[i] };
+        bool found{ index < m_length && m_array_ptr[index] == keys.m_array_ptr[i] };
+        indexes.pushBack(found ? static_cast<int>(index) : -1);
     }
-    return 1;
+    return indexes;
 }
 
-template <typename T>
-int CustomArray<T>::search(const T& value)
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::enableBloomFilter(double falsePositiveRate)
 {
-    if (isSorted())
+    m_bloom_ptr.reset(new CustomBloomFilter<T>{ 0, falsePositiveRate });
+    m_bloom_revision = m_revision - 1;
+}
+
+template <typename T, typename Allocator>
+bool CustomArray<T, Allocator>::mayContain(const T& value) const
+{
+    if (!m_bloom_ptr) { return true; }
+
+    refreshBloom();
+    return m_bloom_ptr->mayContain(value);
+}
+
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::SumType CustomArray<T, Allocator>::sum(std::size_t threads) const
+{
+    return sumRange(m_array_ptr, m_length, threads);
+}
+
+template <typename T, typename Allocator>
+double CustomArray<T, Allocator>::mean(std::size_t threads) const
+{
+    return m_length ? static_cast<double>(sumRange(m_array_ptr, m_length, threads)) / static_cast<double>(m_length) : 0.0;
+}
+
+template <typename T, typename Allocator>
+std::pair<T, T> CustomArray<T, Allocator>::minMax(std::size_t threads) const
+{
+    if (m_length && m_sort_state == SortState::ascending)
     {
-        return binarySearch(value);
+        return std::pair<T, T>{ m_array_ptr[0], m_array_ptr[m_length - 1] };
     }
-    return linearSearch(value);
+    return minMaxRange(m_array_ptr, m_length, threads);
 }
 
-template <typename T>
-void CustomArray<T>::swap(CustomArray<T>& other)
+template <typename T, typename Allocator>
+typename CustomArray<T, Allocator>::SumType CustomArray<T, Allocator>::dot(const CustomArray<T, Allocator>& other, std::size_t threads) const
 {
-    std::swap(m_array_ptr,other.m_array_ptr);
-    std::swap(m_length,other.m_length);
+    return dotRange(m_array_ptr, other.m_array_ptr, (m_length < other.m_length) ? m_length : other.m_length, threads);
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+void CustomArray<T, Allocator>::transform(Function function, std::size_t threads)
+{
+    transformRange(m_array_ptr, m_length, function, threads);
+    m_sort_state = SortState::unknown;
+    ++m_revision;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::fill(const T& value, std::size_t threads)
+{
+    // value may be an element of this array, so it is copied before any element is assigned.
+    T copy(value);
+    fillRange(m_array_ptr, m_length, copy, threads);
+    m_sort_state = SortState::ascending;
+    ++m_revision;
+}
+
+template <typename T, typename Allocator>
+void CustomArray<T, Allocator>::swap(CustomArray<T, Allocator>& other)
+{
+    assert((AllocTraits::propagate_on_container_swap::value || m_allocator == other.m_allocator)
+           && "Arrays with unequal allocators cannot be swapped.");
+    swapAllocator(other, typename AllocTraits::propagate_on_container_swap{});
+    swapData(other);
 }
 
 // Public member functions definitions end here.
 
 // Friend function definitions begin here.
 
-template <typename T>
-std::ostream& operator<<(std::ostream& out, const CustomArray<T>& arr)
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomArray<T, Allocator>& arr)
 {
     return arr.display(out);
 }
 
-template <typename T>
-CustomArray<T> merge(const CustomArray<T>& A, const CustomArray<T>& B)
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> merge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B)
 {
-    auto i{ A.begin() };
-    auto j{ B.begin() };
-    CustomArray<T> merged{};
-    while (i != A.end() && j != B.end())
-    {
-        if (*i < *j)
-        {
-            merged.pushBack(*i);
-            ++i;
-        }
-        else
-        {
-            merged.pushBack(*j);
-            ++j;
-        }
-    }
-    for (; i != A.end(); ++i) { merged.pushBack(*i); }
-    for (; j != B.end(); ++j) { merged.pushBack(*j); }
+    CustomArray<T, Allocator> merged{ A.selectAllocator() };
+    merged.reserve(A.m_length + B.m_length);
+    typename CustomArray<T, Allocator>::ArrayOutput appender{ merged };
+    CustomArray<T, Allocator>::mergeRanges(A.m_array_ptr, A.m_array_ptr + A.m_length, B.m_array_ptr, B.m_array_ptr + B.m_length, appender);
     return merged;
 }
 
-template <typename T>
-CustomArray<T> setUnion(CustomArray<T> A, CustomArray<T> B)
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B)
 {
-    A.bubbleSort();
-    B.bubbleSort();
-    auto i{ A.begin() };
-    auto j{ B.begin() };
-    CustomArray<T> unionArray{};
-    while (i != A.end() && j != B.end())
-    {
-        if (*i < *j)
-        {
-            unionArray.pushBack(*i);
-            ++i;
-        }
-        else if (*i > *j)
-        {
-            unionArray.pushBack(*j);
-            ++j;
-        }
-        else if (*i == *j)
-        {
-            unionArray.pushBack(*i);
-            ++i;
-            ++j;
-        }
-    }
-    for (; i != A.end(); ++i) { unionArray.pushBack(*i); }
-    for (; j != B.end(); ++j) { unionArray.pushBack(*j); }
+    CustomArray<T, Allocator> copyA{ A.m_allocator };
+    CustomArray<T, Allocator> copyB{ B.m_allocator };
+    const CustomArray<T, Allocator>& sortedA{ CustomArray<T, Allocator>::sortedOrCopy(A, copyA) };
+    const CustomArray<T, Allocator>& sortedB{ CustomArray<T, Allocator>::sortedOrCopy(B, copyB) };
+    CustomArray<T, Allocator> unionArray{ A.selectAllocator() };
+    CustomArray<T, Allocator>::unionSorted(sortedA.m_array_ptr, sortedA.m_array_ptr + sortedA.m_length,
+                                           sortedB.m_array_ptr, sortedB.m_array_ptr + sortedB.m_length, unionArray);
     return unionArray;
 }
 
-template <typename T>
-CustomArray<T> setDifference(CustomArray<T> A, CustomArray<T> B)
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B)
 {
-    A.bubbleSort();
-    B.bubbleSort();
-    auto i{ A.begin() };
-    auto j{ B.begin() };
-    CustomArray<T> difference{};
-    while (i != A.end() && j != B.end())
-    {
-        if (*i < *j)
-        {
-            difference.pushBack(*i);
-            ++i;
-        }
-        else if (*i > *j)
-        {
-            ++j;
-        }
-        else if (*i == *j)
-        {
-            ++i;
-            ++j;
-        }
-    }
-    for (; i != A.end(); ++i) { difference.pushBack(*i); }
+    CustomArray<T, Allocator> copyA{ A.m_allocator };
+    CustomArray<T, Allocator> copyB{ B.m_allocator };
+    const CustomArray<T, Allocator>& sortedA{ CustomArray<T, Allocator>::sortedOrCopy(A, copyA) };
+    const CustomArray<T, Allocator>& sortedB{ CustomArray<T, Allocator>::sortedOrCopy(B, copyB) };
+    CustomArray<T, Allocator> difference{ A.selectAllocator() };
+    CustomArray<T, Allocator>::differenceSorted(sortedA.m_array_ptr, sortedA.m_array_ptr + sortedA.m_length,
+                                                sortedB.m_array_ptr, sortedB.m_array_ptr + sortedB.m_length, difference);
     return difference;
 }
 
-template <typename T>
-CustomArray<T> setIntersection(CustomArray<T> A, CustomArray<T> B)
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> setIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B)
+{
+    CustomArray<T, Allocator> copyA{ A.m_allocator };
+    CustomArray<T, Allocator> copyB{ B.m_allocator };
+    const CustomArray<T, Allocator>& sortedA{ CustomArray<T, Allocator>::sortedOrCopy(A, copyA) };
+    const CustomArray<T, Allocator>& sortedB{ CustomArray<T, Allocator>::sortedOrCopy(B, copyB) };
+    CustomArray<T, Allocator> intersection{ A.selectAllocator() };
+    CustomArray<T, Allocator>::intersectionSorted(sortedA.m_array_ptr, sortedA.m_array_ptr + sortedA.m_length,
+                                                  sortedB.m_array_ptr, sortedB.m_array_ptr + sortedB.m_length, intersection);
+    return intersection;
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelMerge(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads)
 {
-    A.bubbleSort();
-    B.bubbleSort();
-    auto i{ A.begin() };
-    auto j{ B.begin() };
-    CustomArray<T> intersection{};
-    while (i != A.end() && j != B.end())
+    threads = CustomArray<T, Allocator>::parallelThreads(threads, A.m_length + B.m_length);
+    T* a{ A.m_array_ptr };
+    T* b{ B.m_array_ptr };
+    std::size_t aLength{ A.m_length };
+    std::size_t bLength{ B.m_length };
+    std::size_t total{ aLength + bLength };
+
+    // Part t of the output is [bounds[t], bounds[t + 1]).
+    std::unique_ptr<std::size_t[]> bounds{ new std::size_t[threads + 1] };
+    for (std::size_t part{ 0 }; part <= threads; ++part)
     {
-        if (*i < *j)
-        {
-            ++i;
-        }
-        else if (*i > *j)
-        {
-            ++j;
-        }
-        else if (*i == *j)
-        {
-            intersection.pushBack(*i);
-            ++i;
-            ++j;
-        }
+        bounds[part] = total / threads * part + ((part < total % threads) ? part : total % threads);
     }
-    return intersection;
+
+    const std::size_t* partBounds{ bounds.get() };
+    CustomArray<T, Allocator> merged{ CustomArray<T, Allocator>::parallelConstruct(A.selectAllocator(), partBounds, threads,
+        [a, b, aLength, bLength, partBounds](std::size_t part, typename CustomArray<T, Allocator>::PointerOutput& writer)
+        {
+            std::size_t first{ partBounds[part] };
+            std::size_t last{ partBounds[part + 1] };
+            std::size_t aFirst{ CustomArray<T, Allocator>::mergePathSplit(a, aLength, b, bLength, first) };
+            std::size_t aLast{ CustomArray<T, Allocator>::mergePathSplit(a, aLength, b, bLength, last) };
+            CustomArray<T, Allocator>::mergeRanges(a + aFirst, a + aLast, b + (first - aFirst), b + (last - aLast), writer);
+        }) };
+    merged.m_sort_state = CustomArray<T, Allocator>::SortState::unknown;
+    return merged;
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetUnion(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads)
+{
+    return CustomArray<T, Allocator>::parallelSetOperation(A, B, threads, typename CustomArray<T, Allocator>::UnionOperation{});
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetDifference(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads)
+{
+    return CustomArray<T, Allocator>::parallelSetOperation(A, B, threads, typename CustomArray<T, Allocator>::DifferenceOperation{});
+}
+
+template <typename T, typename Allocator>
+CustomArray<T, Allocator> parallelSetIntersection(const CustomArray<T, Allocator>& A, const CustomArray<T, Allocator>& B, std::size_t threads)
+{
+    return CustomArray<T, Allocator>::parallelSetOperation(A, B, threads, typename CustomArray<T, Allocator>::IntersectionOperation{});
 }
 
 // Friend functions definitions end here.
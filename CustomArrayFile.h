@@ -0,0 +1,308 @@
+#ifndef CUSTOMARRAYFILE_H_INCLUDED
+#define CUSTOMARRAYFILE_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcmp, std::memcpy, std::memset
+#include <cerrno>       // errno
+#include <type_traits>  // std::is_trivially_copyable, std::is_integral, std::is_floating_point
+#include <stdexcept>    // std::runtime_error
+#include <system_error> // std::system_error
+#include <fcntl.h>      // open
+#include <unistd.h>     // close, pread
+#include <sys/stat.h>   // fstat
+#include <sys/uio.h>    // writev
+#include "CustomArray.h"
+
+
+/*
+ *
+ * File:    CustomArrayFile.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for the binary file format of CustomArray, in the form of a file header struct
+ *   CustomArrayFileHeader, and friend functions saveBinary and loadBinary of the CustomArray class.
+ *
+ *   A file is a 64 byte header, holding a type tag, the element size, the length and a checksum, followed by
+ *   the elements exactly as they are in memory. Nothing is formatted or parsed, so saving and loading are
+ *   bound by the speed of the disk. The same files can be opened with CustomMappedArray, which maps the
+ *   elements into memory instead of reading them.
+ *
+ *   Elements must be trivially copyable, as they are written to the file as they are in memory.
+ *   A file can only be read on a machine with the same byte order as the one that wrote it.
+ *   Requires a POSIX operating system.
+ *
+ */
+
+
+/*
+ *
+ *   Struct Name: CustomArrayFileHeader
+ *
+ *   Purpose:
+ *
+ *     The first 64 bytes of a CustomMappedArray file, or of a CustomArray written in the binary file format.
+ *
+ *   Member Variables:
+ *
+ *     m_magic
+ *       The characters "CUSTARR" and a zero, identifying the file.
+ *     m_version
+ *       The version of the file format.
+ *     m_type_tag
+ *       A number identifying the kind and size of arithmetic element types, or zero for other types.
+ *     m_element_size
+ *       The size of each element in bytes.
+ *     m_length
+ *       The number of elements in the file.
+ *     m_checksum
+ *       A checksum of the elements, or zero if none was computed.
+ *
+ */
+struct CustomArrayFileHeader
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_type_tag;
+    std::uint64_t m_element_size;
+    std::uint64_t m_length;
+    std::uint64_t m_checksum;
+    unsigned char m_reserved[24];
+
+    static constexpr std::uint32_t currentVersion{ 1 };
+};
+
+static_assert(sizeof(CustomArrayFileHeader) == 64, "CustomArrayFileHeader must be 64 bytes.");
+
+/*
+ *
+ * template <typename T>
+ * constexpr std::uint32_t customArrayTypeTag();
+ *
+ * Summary:
+ *
+ *   Returns a number identifying the kind and size of an arithmetic element type.
+ *
+ * Return Value : std::uint32_t tag
+ *
+ * Description:
+ *
+ *   The second byte is 1 for signed integers, 2 for unsigned integers and 3 for floating point numbers,
+ *   and the first byte is the size of the type. Other types return zero, and are told apart by size only.
+ *   Used to stop a file of one element type being opened as an array of another type of the same size.
+ *
+ */
+template <typename T>
+constexpr std::uint32_t customArrayTypeTag()
+{
+    return std::is_floating_point<T>::value ? (3u << 8) | static_cast<std::uint32_t>(sizeof(T))
+         : std::is_integral<T>::value ? ((std::is_signed<T>::value ? 1u : 2u) << 8) | static_cast<std::uint32_t>(sizeof(T))
+         : 0u;
+}
+
+// Fills header for an array of length elements of type T. The checksum is set to zero.
+template <typename T>
+void customArrayMakeHeader(CustomArrayFileHeader& header, std::uint64_t length)
+{
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.m_magic, "CUSTARR", 8);
+    header.m_version = CustomArrayFileHeader::currentVersion;
+    header.m_type_tag = customArrayTypeTag<T>();
+    header.m_element_size = sizeof(T);
+    header.m_length = length;
+}
+
+// Returns whether header was written for an array of type T, by this or an earlier version of the format.
+template <typename T>
+bool customArrayCheckHeader(const CustomArrayFileHeader& header)
+{
+    return std::memcmp(header.m_magic, "CUSTARR", 8) == 0
+        && header.m_version >= 1 && header.m_version <= CustomArrayFileHeader::currentVersion
+        && header.m_type_tag == customArrayTypeTag<T>()
+        && header.m_element_size == sizeof(T);
+}
+
+
+/*
+ *
+ * inline std::uint64_t customArrayChecksum(const void* data, std::size_t bytes);
+ *
+ * Summary:
+ *
+ *   Returns a 64 bit checksum of a block of memory, which is never zero.
+ *
+ * Parameters   : const void* data, std::size_t bytes
+ *
+ * Return Value : std::uint64_t checksum
+ *
+ * Description:
+ *
+ *   Reads the block eight bytes at a time into four independent multiply and rotate accumulators, so the
+ *   multiplications overlap and the checksum keeps up with a fast disk. The accumulators are then combined,
+ *   the remaining bytes are mixed in, and the result is avalanched so every input bit affects every output bit.
+ *   Detects corrupted and truncated files, but is not a cryptographic hash.
+ *
+ */
+inline std::uint64_t customArrayChecksum(const void* data, std::size_t bytes)
+{
+    constexpr std::uint64_t prime1{ 0x9E3779B185EBCA87ull };
+    constexpr std::uint64_t prime2{ 0xC2B2AE3D27D4EB4Full };
+    constexpr std::uint64_t prime3{ 0x165667B19E3779F9ull };
+    auto rotate = [](std::uint64_t x, int bits) { return (x << bits) | (x >> (64 - bits)); };
+    auto mix = [&](std::uint64_t accumulator, std::uint64_t word) { return rotate(accumulator + word * prime2, 31) * prime1; };
+    auto load = [](const unsigned char* ptr) { std::uint64_t word; std::memcpy(&word, ptr, sizeof(word)); return word; };
+
+    const unsigned char* byte_ptr{ static_cast<const unsigned char*>(data) };
+    std::uint64_t lanes[4]{ prime1 + prime2, prime2, 0, 0 - prime1 };
+    std::size_t position{ 0 };
+    for (; position + 32 <= bytes; position += 32)
+    {
+        lanes[0] = mix(lanes[0], load(byte_ptr + position));
+        lanes[1] = mix(lanes[1], load(byte_ptr + position + 8));
+        lanes[2] = mix(lanes[2], load(byte_ptr + position + 16));
+        lanes[3] = mix(lanes[3], load(byte_ptr + position + 24));
+    }
+
+    std::uint64_t hash{ rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18)
+                        + static_cast<std::uint64_t>(bytes) };
+    for (; position + 8 <= bytes; position += 8)
+    {
+        hash = rotate(hash ^ mix(0, load(byte_ptr + position)), 27) * prime1 + prime3;
+    }
+    for (; position < bytes; ++position)
+    {
+        hash = rotate(hash ^ (byte_ptr[position] * prime3), 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash ? hash : 1;
+}
+
+// Closes fd, and throws a std::system_error describing errno and the operation that failed.
+[[noreturn]] inline void customArrayFileFail(int fd, const char* operation)
+{
+    int error{ errno };
+    if (fd >= 0) { close(fd); }
+    throw std::system_error(error, std::generic_category(), operation);
+}
+
+// Reads bytes from fd at offset into data, continuing after partial reads. Returns false if the file ends first.
+inline bool customArrayReadAll(int fd, void* data, std::size_t bytes, off_t offset)
+{
+    unsigned char* byte_ptr{ static_cast<unsigned char*>(data) };
+    while (bytes > 0)
+    {
+        ssize_t bytes_read{ pread(fd, byte_ptr, bytes, offset) };
+        if (bytes_read < 0 && errno == EINTR) { continue; }
+        if (bytes_read < 0) { customArrayFileFail(fd, "pread"); }
+        if (bytes_read == 0) { return false; }
+        byte_ptr += bytes_read;
+        bytes -= static_cast<std::size_t>(bytes_read);
+        offset += bytes_read;
+    }
+    return true;
+}
+
+
+// Friend function definitions begin here.
+
+template <typename T, typename Allocator>
+void saveBinary(const CustomArray<T, Allocator>& arr, const char* path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "saveBinary requires a trivially copyable element type.");
+
+    std::size_t bytes{ arr.m_length * sizeof(T) };
+    CustomArrayFileHeader header{};
+    customArrayMakeHeader<T>(header, arr.m_length);
+    header.m_checksum = customArrayChecksum(arr.m_array_ptr, bytes);
+
+    int fd{ open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+    if (fd < 0) { customArrayFileFail(fd, "open"); }
+
+    // One writev call writes the header and the elements. Linux writes at most about 2 GB per call, so a
+    // partial write continues from where it stopped.
+    struct iovec parts[2]{ { &header, sizeof(header) }, { const_cast<T*>(arr.m_array_ptr), bytes } };
+    int part{ 0 };
+    while (part < 2)
+    {
+        ssize_t written{ writev(fd, parts + part, 2 - part) };
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written < 0) { customArrayFileFail(fd, "writev"); }
+
+        std::size_t remaining{ static_cast<std::size_t>(written) };
+        while (part < 2 && remaining >= parts[part].iov_len)
+        {
+            remaining -= parts[part].iov_len;
+            ++part;
+        }
+        if (part < 2)
+        {
+            parts[part].iov_base = static_cast<unsigned char*>(parts[part].iov_base) + remaining;
+            parts[part].iov_len -= remaining;
+        }
+    }
+    if (close(fd) != 0) { customArrayFileFail(-1, "close"); }
+}
+
+template <typename T, typename Allocator>
+void loadBinary(CustomArray<T, Allocator>& arr, const char* path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "loadBinary requires a trivially copyable element type.");
+
+    int fd{ open(path, O_RDONLY) };
+    if (fd < 0) { customArrayFileFail(fd, "open"); }
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0) { customArrayFileFail(fd, "fstat"); }
+    std::size_t file_bytes{ static_cast<std::size_t>(status.st_size) };
+
+    CustomArrayFileHeader header{};
+    if (file_bytes < sizeof(header) || !customArrayReadAll(fd, &header, sizeof(header), 0)
+        || !customArrayCheckHeader<T>(header)
+        || header.m_length > (file_bytes - sizeof(header)) / sizeof(T))
+    {
+        close(fd);
+        throw std::runtime_error("loadBinary: not an array file of this element type.");
+    }
+
+    // The elements are read straight into a buffer of exactly the right size, which is the only allocation.
+    std::size_t length{ static_cast<std::size_t>(header.m_length) };
+    T* buffer{ length ? arr.allocateBuffer(length) : nullptr };
+    bool complete{ false };
+    try
+    {
+        complete = customArrayReadAll(fd, buffer, length * sizeof(T), static_cast<off_t>(sizeof(header)));
+    }
+    catch (...)
+    {
+        if (buffer) { arr.deallocateBuffer(buffer, length); }
+        throw;
+    }
+    close(fd);
+
+    if (!complete || (header.m_checksum && customArrayChecksum(buffer, length * sizeof(T)) != header.m_checksum))
+    {
+        if (buffer) { arr.deallocateBuffer(buffer, length); }
+        throw std::runtime_error("loadBinary: array file is truncated or corrupted.");
+    }
+
+    arr.clear();
+    arr.m_array_ptr = buffer;
+    arr.m_length = length;
+    arr.m_capacity = length;
+    arr.m_sort_state = (length < 2) ? CustomArray<T, Allocator>::SortState::ascending
+                                    : CustomArray<T, Allocator>::SortState::unknown;
+}
+
+// Friend functions definitions end here.
+
+#endif // CUSTOMARRAYFILE_H_INCLUDED
@@ -0,0 +1,435 @@
+#ifndef CUSTOMARRAYVIEW_H_INCLUDED
+#define CUSTOMARRAYVIEW_H_INCLUDED
+
+#include <cstddef>     // std::size_t
+#include <utility>     // std::declval, std::pair
+#include <type_traits> // std::remove_const, std::is_const, std::is_convertible, std::enable_if
+#include "CustomArray.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomArrayView.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a non-owning view of a contiguous range of elements, in the form of a class
+ *   template CustomArrayView, and the overloads of merge and the set operations that take views.
+ *
+ *   A view is a pointer and a length. It can be made from a CustomArray, CustomSmallArray, CustomMappedArray,
+ *   or any other container with data() and size(), and sliced with subview without copying or allocating.
+ *   A CustomArrayView<const T> only reads the elements, and a CustomArrayView<T> can also change them.
+ *   A CustomArray does not see writes made through a view, so call its invalidate() after them.
+ *
+ *   A view does not keep its container alive. It is invalidated by anything that reallocates or destroys
+ *   the container's elements, such as insertion past the capacity.
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomArrayView
+ *
+ *   Purpose:
+ *
+ *     A non-owning view of a contiguous range of elements.
+ *
+ *   Member Variables:
+ *
+ *     m_data_ptr
+ *       A pointer to the first element of the view.
+ *     m_length
+ *       An unsigned integer (std::size_t) that tracks the number of elements in the view.
+ *
+ *   Member Functions:
+ *
+ *     size
+ *       Returns m_length
+ *     empty
+ *       Returns a bool True if the view has no elements.
+ *     data
+ *       Returns m_data_ptr
+ *     subview
+ *       Returns a view of part of this view.
+ *     sort
+ *       Sorts the viewed elements in ascending order, or by a comparison function, in O(n log n).
+ *     isSorted
+ *       Function to state whether the viewed elements are in ascending order or not.
+ *     search
+ *       Searches the view for a specified value.
+ *     binarySearch
+ *       Searches a sorted view for a specified value in O(log n).
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     sum, mean, minMax, dot
+ *       Returns the sum, mean, least and greatest elements, or dot product of the viewed elements.
+ *     transform, fill
+ *       Replaces every viewed element x with function(x), or with a value.
+ *
+ */
+template <typename T>
+class CustomArrayView
+{
+private:
+
+    using Value = typename std::remove_const<T>::type;
+    using SumType = typename CustomArray<Value>::SumType;
+
+    T* m_data_ptr{};
+    std::size_t m_length{};
+
+public:
+
+    // An empty view.
+    CustomArrayView() noexcept = default;
+
+    // A view of length elements starting at data.
+    CustomArrayView(T* data, std::size_t length) noexcept : m_data_ptr{ data }, m_length{ length } {}
+
+    /*
+     *
+     * template <typename Container>
+     * CustomArrayView(Container& container) noexcept;
+     *
+     * Summary:
+     *
+     *   A view of every element of a container.
+     *
+     * Parameters: Container& container
+     *
+     * Description:
+     *
+     *   Accepts any container whose data() returns a pointer convertible to T*, so a CustomArrayView<const T>
+     *   can view a const container, and a CustomArrayView<T> needs a non-const one.
+     *   The array is not told about writes through the view. After writing through a view, call the
+     *   array's invalidate() before its next search or sort, else its cached sort state, Bloom filter and
+     *   CustomHashIndex may give wrong answers. A view that is only read needs no such call.
+     *
+     */
+    template <typename Container,
+              typename = typename std::enable_if<std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>::type>
+    CustomArrayView(Container& container) noexcept : m_data_ptr{ container.data() }, m_length{ container.size() } {}
+
+    // A view of the same elements as another view, such as a read-only view of a CustomArrayView<T>.
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    CustomArrayView(const CustomArrayView<U>& other) noexcept : m_data_ptr{ other.data() }, m_length{ other.size() } {}
+
+    // Public member function declarations.
+    std::size_t size() const { return m_length; }
+    bool empty() const { return !m_length; }
+    T* data() const { return m_data_ptr; }
+
+    /*
+     *
+     * CustomArrayView<T> subview(std::size_t offset, std::size_t length = static_cast<std::size_t>(-1)) const;
+     *
+     * Summary:
+     *
+     *   Returns a view of part of this view.
+     *
+     * Parameters   : std::size_t offset, std::size_t length
+     *
+     * Return Value : CustomArrayView<T> view
+     *
+     * Description:
+     *
+     *   Returns a view of length elements starting at position offset, or of every element from offset if
+     *   fewer than length remain. An offset past the end gives an empty view. Does not copy or allocate.
+     *
+     */
+    CustomArrayView<T> subview(std::size_t offset, std::size_t length = static_cast<std::size_t>(-1)) const;
+
+    /*
+     *
+     * void sort() const;
+     * template <typename Compare>
+     * void sort(Compare comp) const;
+     *
+     * Summary:
+     *
+     *   Sorts the viewed elements in ascending order, or by a comparison function, in O(n log n).
+     *
+     * Parameters   : Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sorts the elements in place using the pattern-defeating quicksort of CustomArray.
+     *   Only a view of non-const elements can be sorted.
+     *
+     */
+    void sort() const;
+    template <typename Compare>
+    void sort(Compare comp) const;
+
+    bool isSorted() const;
+
+    // Returns the position of the first element equal to value, or -1, searching with simdFind.
+    int search(const Value& value) const;
+
+    /*
+     *
+     * int binarySearch(const Value& value) const;
+     *
+     * Summary:
+     *
+     *   Searches a sorted view for a specified value in O(log n).
+     *
+     * Parameters   : const Value& value
+     *
+     * Return Value : int position
+     *
+     * Description:
+     *
+     *   Returns the position of the first element equal to value, or -1 if there is none.
+     *   The view must be in ascending order, for example after sort, or a slice of a sorted array.
+     *
+     */
+    int binarySearch(const Value& value) const;
+
+    // Returns the number of elements equal to value, using simdCount.
+    std::size_t count(const Value& value) const;
+
+    /*
+     *
+     * SumType sum(std::size_t threads = 1) const;
+     * double mean(std::size_t threads = 1) const;
+     * std::pair<Value, Value> minMax(std::size_t threads = 1) const;
+     * SumType dot(CustomArrayView<const T> other, std::size_t threads = 1) const;
+     * template <typename Function>
+     * void transform(Function function, std::size_t threads = 1) const;
+     * void fill(const Value& value, std::size_t threads = 1) const;
+     *
+     * Summary:
+     *
+     *   The vectorised reductions and updates of CustomArray, on the viewed elements.
+     *
+     * Parameters   : std::size_t threads
+     *
+     * Return Value : As for the CustomArray member functions of the same names.
+     *
+     * Description:
+     *
+     *   Behave as the CustomArray member functions of the same names, so a column of a CustomSoAArray or a
+     *   slice of a CustomMappedArray can be reduced in place. Only a view of non-const elements can be changed.
+     *
+     */
+    SumType sum(std::size_t threads = 1) const;
+    double mean(std::size_t threads = 1) const;
+    std::pair<Value, Value> minMax(std::size_t threads = 1) const;
+    SumType dot(CustomArrayView<const Value> other, std::size_t threads = 1) const;
+    template <typename Function>
+    void transform(Function function, std::size_t threads = 1) const;
+    void fill(const Value& value, std::size_t threads = 1) const;
+
+    // Index operator overload. Support negative indexing!
+    T& operator[](int position) const;
+
+    T* begin() const { return m_data_ptr; }
+    T* end() const { return m_data_ptr + m_length; }
+
+};
+
+// Returns view if it is sorted, or a view of a copy of it sorted in copy. Used by the set operations on views.
+template <typename T>
+CustomArrayView<const T> sortedViewOrCopy(CustomArrayView<const T> view, CustomArray<T>& copy)
+{
+    if (view.isSorted()) { return view; }
+
+    copy.insert(0, view.begin(), view.end());
+    copy.sort();
+    return CustomArrayView<const T>{ static_cast<const CustomArray<T>&>(copy) };
+}
+
+
+// Operator overload definitions begin here.
+
+template <typename T>
+T& CustomArrayView<T>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    return m_data_ptr[position];
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T>
+CustomArrayView<T> CustomArrayView<T>::subview(std::size_t offset, std::size_t length) const
+{
+    if (offset > m_length) { offset = m_length; }
+    if (length > m_length - offset) { length = m_length - offset; }
+    return CustomArrayView<T>{ m_data_ptr + offset, length };
+}
+
+template <typename T>
+void CustomArrayView<T>::sort() const
+{
+    sort([](const Value& a, const Value& b) { return a < b; });
+}
+
+template <typename T>
+template <typename Compare>
+void CustomArrayView<T>::sort(Compare comp) const
+{
+    static_assert(!std::is_const<T>::value, "A view of const elements cannot be sorted.");
+    if (m_length < 2) { return; }
+
+    // badAllowed is log2(n), the number of unbalanced partitions tolerated before falling back to heapSort.
+    int badAllowed{ 0 };
+    for (std::size_t remaining{ m_length }; remaining > 1; remaining >>= 1)
+    {
+        ++badAllowed;
+    }
+    CustomArray<Value>::pdqSort(m_data_ptr, m_data_ptr + m_length, comp, badAllowed, true);
+}
+
+template <typename T>
+bool CustomArrayView<T>::isSorted() const
+{
+    for (std::size_t position{ 1 }; position < m_length; ++position)
+    {
+        if (m_data_ptr[position - 1] > m_data_ptr[position])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+template <typename T>
+int CustomArrayView<T>::search(const Value& value) const
+{
+    std::size_t position{ simdFind(static_cast<const Value*>(m_data_ptr), m_length, value) };
+    return (position < m_length) ? static_cast<int>(position) : -1;
+}
+
+template <typename T>
+int CustomArrayView<T>::binarySearch(const Value& value) const
+{
+    const Value* position{ CustomArray<Value>::rangeLowerBound(m_data_ptr, m_data_ptr + m_length, value,
+                                                               [](const Value& a, const Value& b) { return a < b; }) };
+    return (position != m_data_ptr + m_length && !(value < *position)) ? static_cast<int>(position - m_data_ptr) : -1;
+}
+
+template <typename T>
+std::size_t CustomArrayView<T>::count(const Value& value) const
+{
+    return simdCount(static_cast<const Value*>(m_data_ptr), m_length, value);
+}
+
+template <typename T>
+typename CustomArrayView<T>::SumType CustomArrayView<T>::sum(std::size_t threads) const
+{
+    return CustomArray<Value>::sumRange(m_data_ptr, m_length, threads);
+}
+
+template <typename T>
+double CustomArrayView<T>::mean(std::size_t threads) const
+{
+    return m_length ? static_cast<double>(sum(threads)) / static_cast<double>(m_length) : 0.0;
+}
+
+template <typename T>
+std::pair<typename CustomArrayView<T>::Value, typename CustomArrayView<T>::Value> CustomArrayView<T>::minMax(std::size_t threads) const
+{
+    return CustomArray<Value>::minMaxRange(m_data_ptr, m_length, threads);
+}
+
+template <typename T>
+typename CustomArrayView<T>::SumType CustomArrayView<T>::dot(CustomArrayView<const Value> other, std::size_t threads) const
+{
+    return CustomArray<Value>::dotRange(m_data_ptr, other.data(), (m_length < other.size()) ? m_length : other.size(), threads);
+}
+
+template <typename T>
+template <typename Function>
+void CustomArrayView<T>::transform(Function function, std::size_t threads) const
+{
+    static_assert(!std::is_const<T>::value, "A view of const elements cannot be changed.");
+    CustomArray<Value>::transformRange(m_data_ptr, m_length, function, threads);
+}
+
+template <typename T>
+void CustomArrayView<T>::fill(const Value& value, std::size_t threads) const
+{
+    static_assert(!std::is_const<T>::value, "A view of const elements cannot be changed.");
+    Value copy(value);
+    CustomArray<Value>::fillRange(m_data_ptr, m_length, copy, threads);
+}
+
+// Public member functions definitions end here.
+
+// Friend function definitions begin here.
+
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> merge(CustomArrayView<U> A, CustomArrayView<V> B)
+{
+    using T = typename std::remove_const<U>::type;
+    static_assert(std::is_same<T, typename std::remove_const<V>::type>::value, "merge requires views of the same element type.");
+
+    CustomArray<T> merged;
+    merged.reserve(A.size() + B.size());
+    typename CustomArray<T>::ArrayOutput appender{ merged };
+    CustomArray<T>::mergeRanges(A.begin(), A.end(), B.begin(), B.end(), appender);
+    return merged;
+}
+
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setUnion(CustomArrayView<U> A, CustomArrayView<V> B)
+{
+    using T = typename std::remove_const<U>::type;
+    static_assert(std::is_same<T, typename std::remove_const<V>::type>::value, "setUnion requires views of the same element type.");
+
+    CustomArray<T> copyA;
+    CustomArray<T> copyB;
+    CustomArrayView<const T> sortedA{ sortedViewOrCopy<T>(A, copyA) };
+    CustomArrayView<const T> sortedB{ sortedViewOrCopy<T>(B, copyB) };
+    CustomArray<T> unionArray;
+    CustomArray<T>::unionSorted(sortedA.begin(), sortedA.end(), sortedB.begin(), sortedB.end(), unionArray);
+    return unionArray;
+}
+
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setDifference(CustomArrayView<U> A, CustomArrayView<V> B)
+{
+    using T = typename std::remove_const<U>::type;
+    static_assert(std::is_same<T, typename std::remove_const<V>::type>::value, "setDifference requires views of the same element type.");
+
+    CustomArray<T> copyA;
+    CustomArray<T> copyB;
+    CustomArrayView<const T> sortedA{ sortedViewOrCopy<T>(A, copyA) };
+    CustomArrayView<const T> sortedB{ sortedViewOrCopy<T>(B, copyB) };
+    CustomArray<T> difference;
+    CustomArray<T>::differenceSorted(sortedA.begin(), sortedA.end(), sortedB.begin(), sortedB.end(), difference);
+    return difference;
+}
+
+template <typename U, typename V>
+CustomArray<typename std::remove_const<U>::type> setIntersection(CustomArrayView<U> A, CustomArrayView<V> B)
+{
+    using T = typename std::remove_const<U>::type;
+    static_assert(std::is_same<T, typename std::remove_const<V>::type>::value, "setIntersection requires views of the same element type.");
+
+    CustomArray<T> copyA;
+    CustomArray<T> copyB;
+    CustomArrayView<const T> sortedA{ sortedViewOrCopy<T>(A, copyA) };
+    CustomArrayView<const T> sortedB{ sortedViewOrCopy<T>(B, copyB) };
+    CustomArray<T> intersection;
+    CustomArray<T>::intersectionSorted(sortedA.begin(), sortedA.end(), sortedB.begin(), sortedB.end(), intersection);
+    return intersection;
+}
+
+// Friend functions definitions end here.
+
+#endif // CUSTOMARRAYVIEW_H_INCLUDED
@@ -0,0 +1,439 @@
+#ifndef CUSTOMBLOOMFILTER_H_INCLUDED
+#define CUSTOMBLOOMFILTER_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t, std::uint64_t, std::uintptr_t
+#include <cstring>     // std::memset, std::memcpy
+#include <cmath>       // std::exp, std::pow, std::sqrt
+#include <functional>  // std::hash
+#include <utility>     // std::swap, std::move
+#include <memory>      // std::unique_ptr
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomBloomFilter.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a split block Bloom filter, in the form of a class template CustomBloomFilter.
+ *   A Bloom filter answers whether a value may have been inserted: a false answer is always right, and a true
+ *   answer is wrong with a small, configurable probability. It is used by CustomArray to answer searches for
+ *   missing values without scanning the array.
+ *
+ *   The filter is an array of 256 bit blocks, each aligned to 32 bytes so it lies in one cache line.
+ *   A value's hash chooses one block, and sets one bit in each of the block's eight 32 bit words, using
+ *   simdBloomInsert and simdBloomCheck. So every check reads one cache line, and with AVX2 takes a handful of
+ *   instructions, where a classic Bloom filter reads one cache line per bit.
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomBloomFilter
+ *
+ *   Purpose:
+ *
+ *     A cache line blocked Bloom filter for values of type T.
+ *
+ *   Member Variables:
+ *
+ *     m_block_count
+ *       An unsigned integer (std::size_t) that tracks the number of 256 bit blocks.
+ *     m_storage
+ *       An array specialised unique pointer that owns the memory holding the blocks.
+ *     m_blocks_ptr
+ *       A pointer into m_storage, aligned to 32 bytes, where the first block starts.
+ *     m_capacity
+ *       An unsigned integer (std::size_t) that tracks the number of values the filter was sized for.
+ *     m_count
+ *       An unsigned integer (std::size_t) that tracks the number of values inserted.
+ *     m_target_rate
+ *       The false positive rate the filter was sized for, at m_capacity values.
+ *     m_hash_function
+ *       A pointer to hashOf, set by the constructors, so that Hash is only used by code that constructs a filter.
+ *
+ *   Member Functions:
+ *
+ *     allocate
+ *       Allocates zeroed memory for a number of blocks.
+ *     hashOf
+ *       Returns the mixed hash of a value.
+ *     rateAt
+ *       Returns the false positive rate at an average number of values per block.
+ *     blocksFor
+ *       Returns the number of blocks that hold a number of values at a false positive rate.
+ *     blockOf
+ *       Returns a pointer to the block that a hash chooses.
+ *     size
+ *       Returns m_count.
+ *     capacity
+ *       Returns m_capacity.
+ *     blockCount
+ *       Returns m_block_count.
+ *     targetRate
+ *       Returns m_target_rate.
+ *     isSaturated
+ *       Returns a bool True if more values have been inserted than the filter was sized for.
+ *     falsePositiveRate
+ *       Returns the expected false positive rate for the values inserted so far.
+ *     insert
+ *       Inserts a value.
+ *     mayContain
+ *       Returns whether a value may have been inserted.
+ *     clear
+ *       Removes every value, keeping the size.
+ *     reset
+ *       Removes every value, and resizes the filter for a number of values and false positive rate.
+ *     swap
+ *       Swaps filter data with another filter.
+ *
+ */
+template <typename T, typename Hash = std::hash<T>>
+class CustomBloomFilter
+{
+private:
+
+    // Each block is eight 32 bit words, aligned to blockBytes.
+    static constexpr std::size_t blockWords{ 8 };
+    static constexpr std::size_t blockBytes{ blockWords * sizeof(std::uint32_t) };
+
+    std::size_t m_block_count{};
+    std::unique_ptr<std::uint32_t[]> m_storage{};
+    std::uint32_t* m_blocks_ptr{};
+    std::size_t m_capacity{};
+    std::size_t m_count{};
+    double m_target_rate{};
+    std::uint64_t (*m_hash_function)(const T&){};
+
+    // Allocates m_block_count zeroed blocks, with one block more than needed so they can be aligned.
+    void allocate();
+
+    // Returns Hash{}(value) multiplied by a large odd constant and folded, so every bit depends on the hash.
+    // The high 32 bits choose the block, and the low 32 bits the bits within it.
+    static std::uint64_t hashOf(const T& value);
+
+    /*
+     *
+     * static double rateAt(double valuesPerBlock);
+     * static std::size_t blocksFor(std::size_t capacity, double rate);
+     *
+     * Summary:
+     *
+     *   Relate the size of the filter to its false positive rate.
+     *
+     * Parameters   : double valuesPerBlock, std::size_t capacity, double rate
+     *
+     * Return Value : double rate, std::size_t blocks
+     *
+     * Description:
+     *
+     *   The number of values in a block is Poisson distributed. With j values in a block, each of the eight
+     *   bits of a missing value is set with probability 1 - (31/32)^j, so rateAt sums the Poisson weighted
+     *   chance that all eight are set. blocksFor finds the largest average number of values per block with
+     *   a rate no greater than rate, by bisection, and returns the number of blocks for capacity values.
+     *   For a 1% rate, this is about 11 bits per value.
+     *
+     */
+    static double rateAt(double valuesPerBlock);
+    static std::size_t blocksFor(std::size_t capacity, double rate);
+
+    // Returns a pointer to the first word of the block that hash chooses.
+    std::uint32_t* blockOf(std::uint64_t hash) const
+    {
+        std::uint64_t block{ ((hash >> 32) * static_cast<std::uint64_t>(m_block_count)) >> 32 };
+        return m_blocks_ptr + static_cast<std::size_t>(block) * blockWords;
+    }
+
+public:
+
+    // An overloaded default constructor that writes a message to the standard output.
+    // The filter has one block, and a 1% target false positive rate.
+    CustomBloomFilter();
+
+    /*
+     *
+     * explicit CustomBloomFilter(std::size_t capacity, double falsePositiveRate = 0.01);
+     *
+     * Summary:
+     *
+     *   Initialises a filter sized for a number of values and false positive rate.
+     *
+     * Parameters: std::size_t capacity, double falsePositiveRate
+     *
+     * Description:
+     *
+     *   Allocates the fewest blocks that keep the false positive rate at or below falsePositiveRate once
+     *   capacity values have been inserted, using blocksFor. More values can be inserted, but the rate grows.
+     *   falsePositiveRate is clamped to [1e-9, 0.5].
+     *
+     */
+    explicit CustomBloomFilter(std::size_t capacity, double falsePositiveRate = 0.01);
+
+    // Copy and move constructors. The moved-from filter is left with no blocks, and must be reset before use.
+    CustomBloomFilter(const CustomBloomFilter<T, Hash>& other);
+    CustomBloomFilter(CustomBloomFilter<T, Hash>&& other) noexcept;
+
+    // A destructor that writes a message to the standard output.
+    ~CustomBloomFilter() noexcept;
+
+    // Copy and move assignment operator overloads.
+    CustomBloomFilter& operator=(const CustomBloomFilter<T, Hash>& other);
+    CustomBloomFilter& operator=(CustomBloomFilter<T, Hash>&& other) noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_count; }
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t blockCount() const { return m_block_count; }
+    double targetRate() const { return m_target_rate; }
+    bool isSaturated() const { return m_count > m_capacity; }
+
+    // Returns the expected false positive rate for the values inserted so far.
+    double falsePositiveRate() const { return m_block_count ? rateAt(static_cast<double>(m_count) / static_cast<double>(m_block_count)) : 1.0; }
+
+    // Inserts value, setting its eight bits in one block.
+    void insert(const T& value);
+
+    /*
+     *
+     * bool mayContain(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns whether a value may have been inserted.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : bool
+     *
+     * Description:
+     *
+     *   Returns false if value has certainly not been inserted. Returns true if it has been, or, with
+     *   probability falsePositiveRate(), if it has not. Reads one cache line.
+     *
+     */
+    bool mayContain(const T& value) const;
+
+    // Removes every value, keeping the number of blocks.
+    void clear();
+
+    // Removes every value, and resizes the filter for capacity values at falsePositiveRate.
+    // Reuses the memory if the number of blocks is unchanged.
+    void reset(std::size_t capacity, double falsePositiveRate);
+
+    // Swaps the blocks and sizes of two filters.
+    void swap(CustomBloomFilter<T, Hash>& other);
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T, typename Hash>
+void CustomBloomFilter<T, Hash>::allocate()
+{
+    std::size_t words{ (m_block_count + 1) * blockWords };
+    m_storage.reset(new std::uint32_t[words]);
+    std::memset(m_storage.get(), 0, words * sizeof(std::uint32_t));
+    m_blocks_ptr = m_storage.get();
+    std::uintptr_t misalignment{ reinterpret_cast<std::uintptr_t>(m_blocks_ptr) % blockBytes };
+    if (misalignment != 0)
+    {
+        m_blocks_ptr += (blockBytes - misalignment) / sizeof(std::uint32_t);
+    }
+}
+
+template <typename T, typename Hash>
+std::uint64_t CustomBloomFilter<T, Hash>::hashOf(const T& value)
+{
+    std::uint64_t hash{ static_cast<std::uint64_t>(Hash{}(value)) * 0x9E3779B97F4A7C15ull };
+    return hash ^ (hash >> 29);
+}
+
+template <typename T, typename Hash>
+double CustomBloomFilter<T, Hash>::rateAt(double valuesPerBlock)
+{
+    if (valuesPerBlock <= 0.0) { return 0.0; }
+
+    double rate{ 0.0 };
+    double weight{ std::exp(-valuesPerBlock) };
+    std::size_t last{ static_cast<std::size_t>(valuesPerBlock + 12.0 * std::sqrt(valuesPerBlock) + 16.0) };
+    for (std::size_t values{ 0 }; values <= last; ++values)
+    {
+        rate += weight * std::pow(1.0 - std::pow(31.0 / 32.0, static_cast<double>(values)), 8.0);
+        weight *= valuesPerBlock / static_cast<double>(values + 1);
+    }
+    return rate;
+}
+
+template <typename T, typename Hash>
+std::size_t CustomBloomFilter<T, Hash>::blocksFor(std::size_t capacity, double rate)
+{
+    double low{ 0.0 };
+    double high{ 256.0 };
+    for (int step{ 0 }; step < 50; ++step)
+    {
+        double middle{ (low + high) / 2.0 };
+        if (rateAt(middle) > rate)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+        }
+    }
+    double blocks{ static_cast<double>(capacity) / ((low > 0.0) ? low : 1e-9) };
+    return (blocks < 1.0) ? 1 : static_cast<std::size_t>(blocks) + 1;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>::CustomBloomFilter()
+    : m_hash_function{ &hashOf }
+{
+    std::cout << "CustomBloomFilter default constructor called.\n";
+    reset(0, 0.01);
+}
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>::CustomBloomFilter(std::size_t capacity, double falsePositiveRate)
+    : m_hash_function{ &hashOf }
+{
+    std::cout << "CustomBloomFilter (capacity) constructor called.\n";
+    reset(capacity, falsePositiveRate);
+}
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>::CustomBloomFilter(const CustomBloomFilter<T, Hash>& other)
+    : m_block_count{ other.m_block_count }
+    , m_capacity{ other.m_capacity }
+    , m_count{ other.m_count }
+    , m_target_rate{ other.m_target_rate }
+    , m_hash_function{ other.m_hash_function }
+{
+    std::cout << "CustomBloomFilter copy constructor called.\n";
+    if (m_block_count)
+    {
+        allocate();
+        std::memcpy(m_blocks_ptr, other.m_blocks_ptr, m_block_count * blockBytes);
+    }
+}
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>::CustomBloomFilter(CustomBloomFilter<T, Hash>&& other) noexcept
+    : m_block_count{ other.m_block_count }
+    , m_storage{ std::move(other.m_storage) }
+    , m_blocks_ptr{ other.m_blocks_ptr }
+    , m_capacity{ other.m_capacity }
+    , m_count{ other.m_count }
+    , m_target_rate{ other.m_target_rate }
+    , m_hash_function{ other.m_hash_function }
+{
+    std::cout << "CustomBloomFilter move constructor called.\n";
+    other.m_block_count = 0;
+    other.m_blocks_ptr = nullptr;
+    other.m_capacity = 0;
+    other.m_count = 0;
+}
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>::~CustomBloomFilter() noexcept
+{
+    std::cout << "CustomBloomFilter destructor called.\n";
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>& CustomBloomFilter<T, Hash>::operator=(const CustomBloomFilter<T, Hash>& other)
+{
+    if (this != &other)
+    {
+        CustomBloomFilter<T, Hash> copy{ other };
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Hash>
+CustomBloomFilter<T, Hash>& CustomBloomFilter<T, Hash>::operator=(CustomBloomFilter<T, Hash>&& other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, typename Hash>
+void CustomBloomFilter<T, Hash>::insert(const T& value)
+{
+    std::uint64_t hash{ m_hash_function(value) };
+    simdBloomInsert(blockOf(hash), static_cast<std::uint32_t>(hash));
+    ++m_count;
+}
+
+template <typename T, typename Hash>
+bool CustomBloomFilter<T, Hash>::mayContain(const T& value) const
+{
+    std::uint64_t hash{ m_hash_function(value) };
+    return simdBloomCheck(blockOf(hash), static_cast<std::uint32_t>(hash));
+}
+
+template <typename T, typename Hash>
+void CustomBloomFilter<T, Hash>::clear()
+{
+    if (m_block_count)
+    {
+        std::memset(m_blocks_ptr, 0, m_block_count * blockBytes);
+    }
+    m_count = 0;
+}
+
+template <typename T, typename Hash>
+void CustomBloomFilter<T, Hash>::reset(std::size_t capacity, double falsePositiveRate)
+{
+    if (!(falsePositiveRate >= 1e-9)) { falsePositiveRate = 1e-9; }
+    if (falsePositiveRate > 0.5) { falsePositiveRate = 0.5; }
+
+    std::size_t block_count{ blocksFor(capacity, falsePositiveRate) };
+    m_capacity = capacity;
+    m_target_rate = falsePositiveRate;
+    if (block_count == m_block_count && m_storage)
+    {
+        clear();
+        return;
+    }
+    m_block_count = block_count;
+    m_count = 0;
+    allocate();
+}
+
+template <typename T, typename Hash>
+void CustomBloomFilter<T, Hash>::swap(CustomBloomFilter<T, Hash>& other)
+{
+    std::swap(m_block_count, other.m_block_count);
+    m_storage.swap(other.m_storage);
+    std::swap(m_blocks_ptr, other.m_blocks_ptr);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_count, other.m_count);
+    std::swap(m_target_rate, other.m_target_rate);
+    std::swap(m_hash_function, other.m_hash_function);
+}
+
+// Public member functions definitions end here.
+
+#endif // CUSTOMBLOOMFILTER_H_INCLUDED
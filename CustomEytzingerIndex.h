@@ -0,0 +1,508 @@
+#ifndef CUSTOMEYTZINGERINDEX_H_INCLUDED
+#define CUSTOMEYTZINGERINDEX_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uintptr_t
+#include <utility>  // std::swap
+#include <memory>   // std::unique_ptr
+#include <cassert>
+#include "CustomArray.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomEytzingerIndex.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a read-only search index in the form of a class template CustomEytzingerIndex.
+ *   The index is built from a sorted CustomArray, and answers searches faster than a binary search of the
+ *   array itself once the array is too large to fit in the processor cache.
+ *
+ *   A binary search of a sorted array reads elements that are far apart, so nearly every comparison waits
+ *   for a cache miss. The index stores the elements in Eytzinger (breadth first) order instead: the root of
+ *   the search tree is element 1, and the children of element k are elements 2k and 2k + 1.
+ *   The elements compared at the top of every search are then next to each other in memory, and the
+ *   descendants of an element a few levels down share one cache line, which is prefetched in advance.
+ *
+ *   The template class has been tested with the following data types:
+ *     * Integers
+ *     * Floats
+ *     * Doubles
+ *     * Characters
+ *     * C++ strings (std::string)
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomEytzingerIndex
+ *
+ *   Purpose:
+ *
+ *     A read-only search index over the elements of a sorted CustomArray.
+ *
+ *   Member Variables:
+ *
+ *     m_length
+ *       An unsigned integer (std::size_t) that tracks the number of elements in the index.
+ *     m_storage
+ *       An array specialised unique pointer that owns the memory holding the elements.
+ *     m_tree_ptr
+ *       A pointer into m_storage, aligned to a cache line, where m_tree_ptr[1] is the root of the search tree.
+ *     m_depth
+ *       The depth of the deepest level of the tree, where the root is at depth zero.
+ *     m_last_length
+ *       The number of elements in the deepest level of the tree.
+ *
+ *   Member Functions:
+ *
+ *     allocate
+ *       Allocates memory for an index of the specified length.
+ *     deepCopy
+ *       Performs a deep copy of another index.
+ *     build
+ *       Copies the elements of a sorted array into the index in Eytzinger order.
+ *     descend
+ *       Returns the tree position of the first element that is not less than a value.
+ *     rankOf
+ *       Returns the position in the sorted array of the element at a tree position.
+ *     size
+ *       Returns m_length.
+ *     empty
+ *       Returns a bool True if m_length is zero. Else, returns False.
+ *     lowerBound
+ *       Returns the position in the sorted array of the first element that is not less than a value.
+ *     search
+ *       Searches the index for a specified value.
+ *     contains
+ *       Returns whether the index contains a specified value.
+ *     swap
+ *       Swaps index data with another index.
+ *
+ */
+template <typename T>
+class CustomEytzingerIndex
+{
+private:
+
+    // The number of elements in one 64 byte cache line, and so the number of descendants four levels
+    // (for 4 byte elements) below an element that are prefetched together.
+    static constexpr std::size_t cacheLineBytes{ 64 };
+    static constexpr std::size_t blockLength{ (sizeof(T) < cacheLineBytes) ? cacheLineBytes / sizeof(T) : 1 };
+
+    std::size_t m_length{};
+    std::unique_ptr<T[]> m_storage{};
+    T* m_tree_ptr{};
+    unsigned m_depth{};
+    std::size_t m_last_length{};
+
+    /*
+     *
+     * void allocate(std::size_t length);
+     *
+     * Summary:
+     *
+     *   Allocates memory for an index of the specified length.
+     *
+     * Parameters   : std::size_t length
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Allocates one cache line more than the tree needs, and points m_tree_ptr at the first element
+     *   whose address is a multiple of the cache line size, when the element size divides the cache line size.
+     *   Element zero of the tree is unused, so the tree holds length + 1 elements.
+     *   Sets m_depth and m_last_length for the shape of a tree of length elements.
+     *
+     */
+    void allocate(std::size_t length);
+
+    /*
+     *
+     * void deepCopy(const CustomEytzingerIndex<T>& other);
+     *
+     * Summary:
+     *
+     *   Performs a deep copy of another index.
+     *
+     * Parameters   : CustomEytzingerIndex<T>& other
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Allocates a new portion of memory equal in size to the other index.
+     *   Copies the elements of the other index to the newly allocated memory.
+     *   Called by the copy constructor and overloaded copy assignment member function.
+     *
+     */
+    void deepCopy(const CustomEytzingerIndex<T>& other);
+
+    /*
+     *
+     * std::size_t build(const T* sorted, std::size_t rank, std::size_t k);
+     *
+     * Summary:
+     *
+     *   Copies the elements of a sorted array into the index in Eytzinger order.
+     *
+     * Parameters   : const T* sorted, std::size_t rank, std::size_t k
+     *
+     * Return Value : std::size_t rank
+     *
+     * Description:
+     *
+     *   Visits the subtree rooted at element k in order (left subtree, element k, right subtree),
+     *   copying sorted[rank] into each element visited and incrementing rank.
+     *   Returns the rank of the next element of sorted to be copied.
+     *   The recursion depth is log2 of the array length.
+     *
+     */
+    std::size_t build(const T* sorted, std::size_t rank, std::size_t k);
+
+    /*
+     *
+     * std::size_t descend(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the tree position of the first element that is not less than a value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : std::size_t k, or zero.
+     *
+     * Description:
+     *
+     *   Descends the tree from the root, moving to child 2k + 1 if element k is less than value,
+     *   or to child 2k otherwise. The choice is computed without a branch.
+     *   Each step prefetches the cache line holding the descendants of element k a few levels down,
+     *   so the memory latency of later steps overlaps with the comparisons of earlier steps.
+     *   Once the descent leaves the tree, the trailing right turns are removed from k to return to the
+     *   last element where the descent turned left. Returns zero if every element is less than value.
+     *
+     */
+    std::size_t descend(const T& value) const;
+
+    /*
+     *
+     * std::size_t rankOf(std::size_t k) const;
+     *
+     * Summary:
+     *
+     *   Returns the position in the sorted array of the element at a tree position.
+     *
+     * Parameters   : std::size_t k
+     *
+     * Return Value : std::size_t rank
+     *
+     * Description:
+     *
+     *   In a perfect tree whose deepest level is m_depth, the element at depth d and offset i within its level
+     *   is preceded in order by (2i + 1) * 2^(m_depth - d) - 1 elements, one in every second position being
+     *   in the deepest level. The deepest level of the index is filled from the left with m_last_length
+     *   elements, so the missing elements of that level before k are subtracted.
+     *   Computed from k alone, so a search reads no memory after its descent.
+     *
+     */
+    std::size_t rankOf(std::size_t k) const;
+
+public:
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomEytzingerIndex() noexcept;
+
+    /*
+     *
+     * template <typename Allocator>
+     * explicit CustomEytzingerIndex(const CustomArray<T, Allocator>& sorted);
+     *
+     * Summary:
+     *
+     *   Initialises an index from a sorted array.
+     *
+     * Parameters: const CustomArray<T, Allocator>& sorted
+     *
+     * Description:
+     *
+     *   Copies the elements of sorted into the index in Eytzinger order, using build.
+     *   The elements of sorted must be in ascending order. The index does not change if sorted changes.
+     *
+     */
+    template <typename Allocator>
+    explicit CustomEytzingerIndex(const CustomArray<T, Allocator>& sorted);
+
+    // Copy and move constructors. The moved-from index is left empty.
+    CustomEytzingerIndex(const CustomEytzingerIndex<T>& other);
+    CustomEytzingerIndex(CustomEytzingerIndex<T>&& other) noexcept;
+
+    // A destructor that writes a message to the standard output.
+    ~CustomEytzingerIndex() noexcept;
+
+    // Copy and move assignment operator overloads.
+    CustomEytzingerIndex& operator=(const CustomEytzingerIndex<T>& other);
+    CustomEytzingerIndex& operator=(CustomEytzingerIndex<T>&& other) noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_length; }
+    bool empty() const { return !m_length; }
+
+    /*
+     *
+     * std::size_t lowerBound(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the position in the sorted array of the first element that is not less than a value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : std::size_t position
+     *
+     * Description:
+     *
+     *   Finds the element using descend, and computes its rank using rankOf.
+     *   Returns size() if every element is less than value. O(log n).
+     *
+     */
+    std::size_t lowerBound(const T& value) const;
+
+    /*
+     *
+     * int search(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Searches the index for a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : int index or -1.
+     *
+     * Description:
+     *
+     *   Returns the position in the sorted array of the first element that is equal to value, or -1.
+     *   Returns the same result as CustomArray::search on the array the index was built from.
+     *
+     */
+    int search(const T& value) const;
+
+    // Returns whether an element of the index is equal to value.
+    bool contains(const T& value) const { return search(value) >= 0; }
+
+    /*
+     *
+     * void swap(CustomEytzingerIndex<T>& other);
+     *
+     * Summary:
+     *
+     *   Swaps index data with another index.
+     *
+     * Parameters   : CustomEytzingerIndex<T>& other
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Switches the memory, tree pointer, tree shape and length of the index with other.
+     *
+     */
+    void swap(CustomEytzingerIndex<T>& other);
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T>
+void CustomEytzingerIndex<T>::allocate(std::size_t length)
+{
+    std::size_t padding{ (cacheLineBytes % sizeof(T) == 0) ? blockLength : 0 };
+    m_storage.reset(new T[length + 1 + padding]);
+    m_tree_ptr = m_storage.get();
+    if (padding)
+    {
+        std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(m_tree_ptr) };
+        std::size_t misalignment{ static_cast<std::size_t>(address % cacheLineBytes) };
+        if (misalignment % sizeof(T) == 0 && misalignment != 0)
+        {
+            m_tree_ptr += (cacheLineBytes - misalignment) / sizeof(T);
+        }
+    }
+    m_length = length;
+    m_depth = simdHighestBit64(length);
+    m_last_length = length - ((std::size_t{ 1 } << m_depth) - 1);
+}
+
+template <typename T>
+void CustomEytzingerIndex<T>::deepCopy(const CustomEytzingerIndex<T>& other)
+{
+    if (other.m_length > 0)
+    {
+        allocate(other.m_length);
+        for (std::size_t k{ 1 }; k <= m_length; ++k)
+        {
+            m_tree_ptr[k] = other.m_tree_ptr[k];
+        }
+    }
+    else
+    {
+        m_storage.reset(nullptr);
+        m_tree_ptr = nullptr;
+        m_length = 0;
+        m_depth = 0;
+        m_last_length = 0;
+    }
+}
+
+template <typename T>
+std::size_t CustomEytzingerIndex<T>::build(const T* sorted, std::size_t rank, std::size_t k)
+{
+    if (k > m_length) { return rank; }
+
+    rank = build(sorted, rank, 2 * k);
+    assert((rank == 0 || !(sorted[rank - 1] > sorted[rank])) && "Array elements must be in ascending order.");
+    m_tree_ptr[k] = sorted[rank];
+    return build(sorted, rank + 1, 2 * k + 1);
+}
+
+template <typename T>
+std::size_t CustomEytzingerIndex<T>::descend(const T& value) const
+{
+    std::uintptr_t tree_address{ reinterpret_cast<std::uintptr_t>(m_tree_ptr) };
+    std::size_t k{ 1 };
+    while (k <= m_length)
+    {
+        simdPrefetch(reinterpret_cast<const void*>(tree_address + k * blockLength * sizeof(T)));
+        k = 2 * k + static_cast<std::size_t>(m_tree_ptr[k] < value);
+    }
+
+    // Each right turn appended a 1 bit to k, and each left turn a 0 bit.
+    // Removing the trailing 1 bits and the 0 bit before them undoes the descent back to the last left turn.
+    k >>= simdLowestBit64(~static_cast<std::uint64_t>(k)) + 1;
+    return k;
+}
+
+template <typename T>
+std::size_t CustomEytzingerIndex<T>::rankOf(std::size_t k) const
+{
+    unsigned depth{ simdHighestBit64(k) };
+    std::size_t offset{ k - (std::size_t{ 1 } << depth) };
+    std::size_t rank{ ((2 * offset + 1) << (m_depth - depth)) - 1 };
+
+    // Every second position up to rank belongs to the deepest level, which only has m_last_length elements.
+    std::size_t deepest{ (rank + 1) / 2 };
+    return rank - ((deepest > m_last_length) ? deepest - m_last_length : 0);
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T>
+CustomEytzingerIndex<T>::CustomEytzingerIndex() noexcept
+{
+    std::cout << "CustomEytzingerIndex default constructor called.\n";
+}
+
+template <typename T>
+template <typename Allocator>
+CustomEytzingerIndex<T>::CustomEytzingerIndex(const CustomArray<T, Allocator>& sorted)
+{
+    std::cout << "CustomEytzingerIndex (array) constructor called.\n";
+    if (!sorted.empty())
+    {
+        allocate(sorted.size());
+        build(sorted.data(), 0, 1);
+    }
+}
+
+template <typename T>
+CustomEytzingerIndex<T>::CustomEytzingerIndex(const CustomEytzingerIndex<T>& other)
+{
+    std::cout << "CustomEytzingerIndex copy constructor called.\n";
+    deepCopy(other);
+}
+
+template <typename T>
+CustomEytzingerIndex<T>::CustomEytzingerIndex(CustomEytzingerIndex<T>&& other) noexcept
+    : m_length{ other.m_length }
+    , m_storage{ std::move(other.m_storage) }
+    , m_tree_ptr{ other.m_tree_ptr }
+    , m_depth{ other.m_depth }
+    , m_last_length{ other.m_last_length }
+{
+    std::cout << "CustomEytzingerIndex move constructor called.\n";
+    other.m_length = 0;
+    other.m_tree_ptr = nullptr;
+    other.m_depth = 0;
+    other.m_last_length = 0;
+}
+
+template <typename T>
+CustomEytzingerIndex<T>::~CustomEytzingerIndex() noexcept
+{
+    std::cout << "CustomEytzingerIndex destructor called.\n";
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T>
+CustomEytzingerIndex<T>& CustomEytzingerIndex<T>::operator=(const CustomEytzingerIndex<T>& other)
+{
+    if (this != &other)
+    {
+        deepCopy(other);
+    }
+    return *this;
+}
+
+template <typename T>
+CustomEytzingerIndex<T>& CustomEytzingerIndex<T>::operator=(CustomEytzingerIndex<T>&& other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T>
+std::size_t CustomEytzingerIndex<T>::lowerBound(const T& value) const
+{
+    std::size_t k{ descend(value) };
+    return (k == 0) ? m_length : rankOf(k);
+}
+
+template <typename T>
+int CustomEytzingerIndex<T>::search(const T& value) const
+{
+    std::size_t k{ descend(value) };
+    if (k == 0 || value < m_tree_ptr[k]) { return -1; }
+    return static_cast<int>(rankOf(k));
+}
+
+template <typename T>
+void CustomEytzingerIndex<T>::swap(CustomEytzingerIndex<T>& other)
+{
+    std::swap(m_length, other.m_length);
+    m_storage.swap(other.m_storage);
+    std::swap(m_tree_ptr, other.m_tree_ptr);
+    std::swap(m_depth, other.m_depth);
+    std::swap(m_last_length, other.m_last_length);
+}
+
+// Public member functions definitions end here.
+
+#endif // CUSTOMEYTZINGERINDEX_H_INCLUDED
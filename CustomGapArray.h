@@ -0,0 +1,899 @@
+#ifndef CUSTOMGAPARRAY_H_INCLUDED
+#define CUSTOMGAPARRAY_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <utility>     // std::swap, std::move, std::forward, std::initializer_list
+#include <iterator>    // std::bidirectional_iterator_tag
+#include <memory>      // std::allocator, std::allocator_traits
+#include <type_traits> // std::is_trivially_copyable, std::is_trivially_destructible, std::is_nothrow_move_constructible
+#include <cstring>     // std::memcpy, std::memmove
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomGapArray.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a gap buffer container, in the form of a class template CustomGapArray.
+ *
+ *   The elements are stored in one block of memory with a gap of unused memory at a cursor position.
+ *   The elements before the cursor are at the start of the block, and the elements after it are at the end.
+ *   Inserting at the cursor constructs the element in the gap, and erasing next to the cursor widens the gap,
+ *   so neither moves any other element. Moving the cursor moves the elements between its old and new
+ *   position across the gap, so it costs O(distance). Edits that stay near one position, as in a text editor,
+ *   are O(1), where CustomArray::insert and CustomArray::erase are O(n).
+ *
+ *   When the gap is used up, the memory grows geometrically, and the gap is placed at the cursor again.
+ *
+ */
+
+
+// Forward declarations of class template CustomGapArray and associated friend functions begin here.
+// Required to support class template functionality.
+
+
+/*
+ *
+ *   Class Name: CustomGapArray
+ *
+ *   Purpose:
+ *
+ *     A custom array container class template with a movable gap, for fast edits near a cursor.
+ *
+ *   Member Variables:
+ *
+ *     m_capacity
+ *       An unsigned integer (std::size_t) that tracks the number of elements the memory can hold.
+ *     m_gap_begin
+ *       An unsigned integer (std::size_t) that tracks the start of the gap. It is also the cursor position,
+ *       and the number of elements before the gap.
+ *     m_gap_end
+ *       An unsigned integer (std::size_t) that tracks the end of the gap, where the elements after the cursor start.
+ *     m_array_ptr
+ *       A pointer to the memory. Only the elements [0, m_gap_begin) and [m_gap_end, m_capacity) are constructed.
+ *     m_allocator
+ *       An Allocator object that allocates and deallocates the memory.
+ *
+ *   Member Functions:
+ *
+ *     constructMoves
+ *       Move-constructs elements in uninitialised memory.
+ *     destroyRange
+ *       Destroys elements, leaving uninitialised memory.
+ *     relocate
+ *       Moves elements to uninitialised memory, and destroys them where they were.
+ *     reallocate
+ *       Moves the array data into memory of the specified capacity, with the gap at the specified cursor.
+ *     display
+ *       Prints the array data to the specified output stream.
+ *     size
+ *       Returns the number of elements.
+ *     empty
+ *       Returns a bool True if the array has no elements.
+ *     capacity
+ *       Returns m_capacity
+ *     cursor
+ *       Returns the cursor position.
+ *     gapSize
+ *       Returns the number of elements that can be inserted without allocating.
+ *     moveCursor
+ *       Moves the gap to the specified position.
+ *     reserve
+ *       Allocates memory for at least the specified number of elements.
+ *     clear
+ *       Removes the array data from memory and the array.
+ *     insert
+ *       Inserts data into the array at the specified position.
+ *     emplace
+ *       Constructs a new element in place at the specified position.
+ *     erase
+ *       Removes data from the array at the specified position.
+ *     pushBack
+ *       Appends a new value to the end of the array.
+ *     popBack
+ *       Removes an existing value from the end of the array.
+ *     search
+ *       Searches the array for a specified value.
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     swap
+ *       Swaps array data with another array.
+ *
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class CustomGapArray;
+
+/*
+ *
+ * template <typename T, typename Allocator>
+ * std::ostream& operator<<(std::ostream& out, const CustomGapArray<T, Allocator>& arr);
+ *
+ * Summary:
+ *
+ *    Standard output operator overload for a CustomGapArray array object.
+ *
+ * Return Value: None
+ *
+ * Description:
+ *
+ *   Standard output operator overload that has friend privileges within the CustomGapArray class.
+ *   Calls the private member function display.
+ *
+ */
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomGapArray<T, Allocator>& arr);
+
+
+// Forward declaration of template friend functions ends here.
+
+
+template <typename T, typename Allocator>
+class CustomGapArray
+{
+private:
+
+    std::size_t m_capacity{};
+    std::size_t m_gap_begin{};
+    std::size_t m_gap_end{};
+    T* m_array_ptr{};
+    Allocator m_allocator{};
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename AllocTraits::value_type, T>::value,
+                  "Allocator::value_type must be the same as the element type.");
+    static_assert(std::is_same<typename AllocTraits::pointer, T*>::value,
+                  "Allocator must allocate raw pointers.");
+
+    /*
+     *
+     * void constructMoves(T* first, T* last, T* destination);
+     * void destroyRange(T* first, T* last);
+     * void relocate(T* first, T* last, T* destination);
+     *
+     * Summary:
+     *
+     *   Move elements into uninitialised memory, and destroy elements.
+     *
+     * Parameters   : T* first, T* last, T* destination
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   constructMoves move-constructs the elements [first, last) in the uninitialised memory at destination,
+     *   using std::move_if_noexcept, so that the elements [first, last) are unchanged if an exception is thrown.
+     *   destroyRange destroys the elements [first, last).
+     *   relocate moves the elements [first, last) across the gap to destination and destroys them where they
+     *   were, leaving gap memory behind. The two ranges may overlap, so relocate works from the end nearest
+     *   destination. Trivially copyable elements are copied with std::memcpy or std::memmove. relocate cannot
+     *   undo a move that throws, so it is only used for elements whose move constructor does not throw.
+     *
+     */
+    void constructMoves(T* first, T* last, T* destination);
+    void destroyRange(T* first, T* last);
+    void relocate(T* first, T* last, T* destination);
+
+    /*
+     *
+     * void reallocate(std::size_t capacity, std::size_t cursor);
+     *
+     * Summary:
+     *
+     *   Moves the array data into memory of the specified capacity, with the gap at the specified cursor.
+     *
+     * Parameters   : std::size_t capacity, std::size_t cursor
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Allocates memory for capacity elements, moves the elements before cursor to its start and the
+     *   elements from cursor on to its end, then destroys the existing elements and frees the old memory.
+     *   capacity must be no less than the length of the array, and cursor no greater than it.
+     *   If an element throws while being moved, the array is unchanged.
+     *
+     */
+    void reallocate(std::size_t capacity, std::size_t cursor);
+
+    // Returns the capacity to grow to when the gap is used up. Doubles the current capacity, or returns minimum.
+    std::size_t nextCapacity(std::size_t minimum) const;
+
+    // Returns the position in memory of the element at position index.
+    std::size_t slot(std::size_t index) const { return (index < m_gap_begin) ? index : index + (m_gap_end - m_gap_begin); }
+
+    // Called by the overloaded operator << friend function.
+    std::ostream& display(std::ostream& out) const;
+
+    /*
+     *
+     *   Class Name: GapIterator
+     *
+     *   Purpose:
+     *
+     *     A bidirectional iterator over the elements of a CustomGapArray, which jumps over the gap.
+     *
+     */
+    template <typename Value>
+    class GapIterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+    private:
+        pointer m_ptr;
+        pointer m_gap_begin_ptr;
+        pointer m_gap_end_ptr;
+    public:
+        GapIterator(pointer ptr = nullptr, pointer gap_begin = nullptr, pointer gap_end = nullptr)
+            : m_ptr{ ptr }, m_gap_begin_ptr{ gap_begin }, m_gap_end_ptr{ gap_end } {}
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        GapIterator& operator++() { if (++m_ptr == m_gap_begin_ptr) { m_ptr = m_gap_end_ptr; } return *this; }
+        GapIterator operator++(int) { GapIterator temp{ *this }; ++(*this); return temp; }
+        GapIterator& operator--() { if (m_ptr == m_gap_end_ptr) { m_ptr = m_gap_begin_ptr; } --m_ptr; return *this; }
+        GapIterator operator--(int) { GapIterator temp{ *this }; --(*this); return temp; }
+        friend bool operator==(const GapIterator& a, const GapIterator& b) { return a.m_ptr == b.m_ptr; }
+        friend bool operator!=(const GapIterator& a, const GapIterator& b) { return a.m_ptr != b.m_ptr; }
+    };
+
+public:
+
+    using Iterator = GapIterator<T>;
+    using ConstIterator = GapIterator<const T>;
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomGapArray() noexcept;
+
+    // Initialises an empty array that allocates memory with allocator.
+    explicit CustomGapArray(const Allocator& allocator) noexcept;
+
+    // Initialises an array from a std::initializer_list. The cursor is at the end.
+    CustomGapArray(std::initializer_list<T> elements, const Allocator& allocator = Allocator{}) noexcept;
+
+    // Initialises an array from another array, with the cursor at the end.
+    CustomGapArray(const CustomGapArray<T, Allocator>& other) noexcept;
+
+    // Initialises an array from another array, taking its memory, gap and cursor. other is left empty.
+    CustomGapArray(CustomGapArray<T, Allocator>&& other) noexcept;
+
+    // Initialises an array from two iterators that are compatible with containers in the standard library.
+    template <typename InputIterator>
+    CustomGapArray(InputIterator first, InputIterator last, const Allocator& allocator = Allocator{}) noexcept;
+
+    // Destroys the elements, and frees the memory.
+    ~CustomGapArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_capacity - (m_gap_end - m_gap_begin); }
+    bool empty() const { return !size(); }
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t cursor() const { return m_gap_begin; }
+    std::size_t gapSize() const { return m_gap_end - m_gap_begin; }
+    Allocator getAllocator() const { return m_allocator; }
+
+    /*
+     *
+     * void moveCursor(int position);
+     *
+     * Summary:
+     *
+     *   Moves the gap to the specified position.
+     *
+     * Parameters   : int position
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Moves the elements between the cursor and position across the gap, so that the gap starts before the
+     *   element at position. O(distance), and does not allocate unless moving an element may throw. Such
+     *   elements are moved into new memory by reallocate instead, so that the array is unchanged if one throws.
+     *   A position past the end moves the cursor to the end. insert, emplace and erase move the cursor themselves, so this is only needed to prepare for
+     *   edits ahead of time.
+     *   Support negative indexing!
+     *
+     */
+    void moveCursor(int position);
+
+    // Allocates memory for at least capacity elements, so the gap holds at least capacity - size() elements.
+    void reserve(std::size_t capacity);
+
+    // Destroys the elements and frees the memory.
+    void clear();
+
+    // Copies value into the array at position, and leaves the cursor after it. Support negative indexing!
+    void insert(int position, const T& value);
+
+    /*
+     *
+     * template <typename... Args>
+     * void emplace(int position, Args&&... args);
+     *
+     * Summary:
+     *
+     *   Constructs a new element in place at the specified position.
+     *
+     * Parameters   : int position, Args&&... args
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Moves the cursor to position, and constructs the element from args at the start of the gap, leaving
+     *   the cursor after the new element. Consecutive insertions at the cursor, such as typing, are O(1).
+     *   If the gap is used up, grows the capacity geometrically and constructs the element directly in the new
+     *   memory, before moving the existing elements around it.
+     *   Support negative indexing!
+     *
+     */
+    template <typename... Args>
+    void emplace(int position, Args&&... args);
+
+    /*
+     *
+     * void erase(int position);
+     *
+     * Summary:
+     *
+     *   Removes data from the array at the specified position.
+     *
+     * Parameters   : int position
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If the element is just before the cursor, it is destroyed and the gap grows backwards, as for a
+     *   backspace key. Else, the cursor is moved to position, and the element after the gap is destroyed, as for
+     *   a delete key. Either way, no other element moves if position is next to the cursor, so erasing
+     *   repeatedly at the cursor is O(1). The capacity of the array is unchanged.
+     *   Support negative indexing!
+     *
+     */
+    void erase(int position);
+
+    // Appends value to the end of the array, moving the cursor to the end.
+    void pushBack(const T& value);
+    void pushBack(T&& value);
+
+    // Removes the last element, moving the cursor to the end.
+    void popBack();
+
+    // Returns the position of the first element equal to value, or -1, searching each side of the gap with simdFind.
+    int search(const T& value) const;
+
+    // Returns the number of elements equal to value, using simdCount on each side of the gap.
+    std::size_t count(const T& value) const;
+
+    // Swaps array data with another array.
+    void swap(CustomGapArray<T, Allocator>& other);
+
+    // Index operator overloads, which skip the gap. Support negative indexing!
+    T& operator[](int position);
+    const T& operator[](int position) const;
+
+    // Copy assignment operator overload. Copies the elements of other, with the cursor at the end.
+    CustomGapArray& operator=(const CustomGapArray<T, Allocator>& other);
+
+    // Move assignment operator overload. Takes the memory of other.
+    CustomGapArray& operator=(CustomGapArray<T, Allocator>&& other);
+
+    // Fully specialised template friend function declarations.
+    friend std::ostream& operator<<<T, Allocator>(std::ostream& out, const CustomGapArray<T, Allocator>& arr);
+
+    Iterator begin() { return Iterator{ m_array_ptr + slot(0), m_array_ptr + m_gap_begin, m_array_ptr + m_gap_end }; }
+    Iterator end() { return Iterator{ m_array_ptr + m_capacity, m_array_ptr + m_gap_begin, m_array_ptr + m_gap_end }; }
+    ConstIterator begin() const { return ConstIterator{ m_array_ptr + slot(0), m_array_ptr + m_gap_begin, m_array_ptr + m_gap_end }; }
+    ConstIterator end() const { return ConstIterator{ m_array_ptr + m_capacity, m_array_ptr + m_gap_begin, m_array_ptr + m_gap_end }; }
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::constructMoves(T* first, T* last, T* destination)
+{
+    if (std::is_trivially_copyable<T>::value)
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void*>(destination), first, static_cast<std::size_t>(last - first) * sizeof(T));
+        }
+        return;
+    }
+
+    T* constructed{ destination };
+    try
+    {
+        for (; first != last; ++first, ++constructed)
+        {
+            AllocTraits::construct(m_allocator, constructed, std::move_if_noexcept(*first));
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, constructed);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::destroyRange(T* first, T* last)
+{
+    if (std::is_trivially_destructible<T>::value) { return; }
+
+    for (; first != last; ++first)
+    {
+        AllocTraits::destroy(m_allocator, first);
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::relocate(T* first, T* last, T* destination)
+{
+    // With no gap, the elements are already in place.
+    if (destination == first) { return; }
+
+    if (std::is_trivially_copyable<T>::value)
+    {
+        if (first != last)
+        {
+            std::memmove(static_cast<void*>(destination), first, static_cast<std::size_t>(last - first) * sizeof(T));
+        }
+        return;
+    }
+
+    if (destination < first)
+    {
+        for (; first != last; ++first, ++destination)
+        {
+            AllocTraits::construct(m_allocator, destination, std::move(*first));
+            AllocTraits::destroy(m_allocator, first);
+        }
+        return;
+    }
+
+    destination += last - first;
+    while (last != first)
+    {
+        --last;
+        --destination;
+        AllocTraits::construct(m_allocator, destination, std::move(*last));
+        AllocTraits::destroy(m_allocator, last);
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::reallocate(std::size_t capacity, std::size_t cursor)
+{
+    std::size_t after{ size() - cursor };
+    std::size_t before{ (cursor < m_gap_begin) ? cursor : m_gap_begin };
+    std::size_t crossing{ cursor - before };
+    T* new_array_ptr{ AllocTraits::allocate(m_allocator, capacity) };
+
+    // The elements before cursor are [0, before) and the first crossing elements after the gap.
+    // The elements from cursor on are the rest of the elements before the gap, and the rest after it.
+    T* firsts[4]{ m_array_ptr, m_array_ptr + m_gap_end, m_array_ptr + before, m_array_ptr + m_gap_end + crossing };
+    T* lasts[4]{ m_array_ptr + before, m_array_ptr + m_gap_end + crossing, m_array_ptr + m_gap_begin, m_array_ptr + m_capacity };
+    T* destinations[4]{ new_array_ptr, new_array_ptr + before, new_array_ptr + capacity - after,
+                        new_array_ptr + capacity - after + (m_gap_begin - before) };
+    std::size_t piece{ 0 };
+    try
+    {
+        for (; piece < 4; ++piece)
+        {
+            constructMoves(firsts[piece], lasts[piece], destinations[piece]);
+        }
+    }
+    catch (...)
+    {
+        while (piece > 0)
+        {
+            --piece;
+            destroyRange(destinations[piece], destinations[piece] + (lasts[piece] - firsts[piece]));
+        }
+        AllocTraits::deallocate(m_allocator, new_array_ptr, capacity);
+        throw;
+    }
+    destroyRange(m_array_ptr, m_array_ptr + m_gap_begin);
+    destroyRange(m_array_ptr + m_gap_end, m_array_ptr + m_capacity);
+    if (m_array_ptr) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+    m_array_ptr = new_array_ptr;
+    m_capacity = capacity;
+    m_gap_begin = cursor;
+    m_gap_end = capacity - after;
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomGapArray<T, Allocator>::nextCapacity(std::size_t minimum) const
+{
+    std::size_t grown{ m_capacity * 2 };
+    return (grown > minimum) ? grown : minimum;
+}
+
+template <typename T, typename Allocator>
+std::ostream& CustomGapArray<T, Allocator>::display(std::ostream& out) const
+{
+    // Characters are printed as a string, without spaces.
+    const char* separator{ std::is_same<T, char>::value ? "" : " " };
+    for (std::size_t position{ 0 }; position < size(); ++position)
+    {
+        if (position > 0) { out << separator; }
+        out << m_array_ptr[slot(position)];
+    }
+    return out;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::CustomGapArray() noexcept
+{
+    std::cout << "CustomGapArray default constructor called.\n";
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::CustomGapArray(const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomGapArray (allocator) constructor called.\n";
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::CustomGapArray(std::initializer_list<T> elements, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomGapArray list-initialised constructor called.\n";
+    reserve(elements.size());
+    for (const T& element : elements)
+    {
+        pushBack(element);
+    }
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::CustomGapArray(const CustomGapArray<T, Allocator>& other) noexcept
+    : m_allocator{ AllocTraits::select_on_container_copy_construction(other.m_allocator) }
+{
+    std::cout << "CustomGapArray copy constructor called.\n";
+    reserve(other.size());
+    for (const T& element : other)
+    {
+        pushBack(element);
+    }
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::CustomGapArray(CustomGapArray<T, Allocator>&& other) noexcept
+    : m_capacity{ other.m_capacity }, m_gap_begin{ other.m_gap_begin }, m_gap_end{ other.m_gap_end },
+      m_array_ptr{ other.m_array_ptr }, m_allocator{ std::move(other.m_allocator) }
+{
+    std::cout << "CustomGapArray move constructor called.\n";
+    other.m_capacity = 0;
+    other.m_gap_begin = 0;
+    other.m_gap_end = 0;
+    other.m_array_ptr = nullptr;
+}
+
+template <typename T, typename Allocator>
+template <typename InputIterator>
+CustomGapArray<T, Allocator>::CustomGapArray(InputIterator first, InputIterator last, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomGapArray (iterator) copy constructor called.\n";
+    while (first != last)
+    {
+        pushBack(*first);
+        ++first;
+    }
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>::~CustomGapArray() noexcept
+{
+    std::cout << "CustomGapArray destructor called.\n";
+    clear();
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T, typename Allocator>
+T& CustomGapArray<T, Allocator>::operator[](int position)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return m_array_ptr[slot(static_cast<std::size_t>(position))];
+}
+
+template <typename T, typename Allocator>
+const T& CustomGapArray<T, Allocator>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return m_array_ptr[slot(static_cast<std::size_t>(position))];
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>& CustomGapArray<T, Allocator>::operator=(const CustomGapArray<T, Allocator>& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    reserve(other.size());
+    for (const T& element : other)
+    {
+        pushBack(element);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+CustomGapArray<T, Allocator>& CustomGapArray<T, Allocator>::operator=(CustomGapArray<T, Allocator>&& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    if (!(m_allocator == other.m_allocator))
+    {
+        reserve(other.size());
+        for (T& element : other)
+        {
+            pushBack(std::move(element));
+        }
+        other.clear();
+        return *this;
+    }
+
+    m_capacity = other.m_capacity;
+    m_gap_begin = other.m_gap_begin;
+    m_gap_end = other.m_gap_end;
+    m_array_ptr = other.m_array_ptr;
+    other.m_capacity = 0;
+    other.m_gap_begin = 0;
+    other.m_gap_end = 0;
+    other.m_array_ptr = nullptr;
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::moveCursor(int position)
+{
+    std::size_t length{ size() };
+    if (position < 0)
+    {
+        position = length ? static_cast<int>(length) - (abs(position) % static_cast<int>(length)) : 0;
+    }
+    std::size_t target{ (static_cast<std::size_t>(position) > length) ? length : static_cast<std::size_t>(position) };
+    if (target == m_gap_begin) { return; }
+
+    if (!std::is_nothrow_move_constructible<T>::value && !std::is_trivially_copyable<T>::value)
+    {
+        reallocate(m_capacity, target);
+        return;
+    }
+
+    if (target < m_gap_begin)
+    {
+        std::size_t distance{ m_gap_begin - target };
+        relocate(m_array_ptr + target, m_array_ptr + m_gap_begin, m_array_ptr + m_gap_end - distance);
+        m_gap_begin -= distance;
+        m_gap_end -= distance;
+    }
+    else
+    {
+        std::size_t distance{ target - m_gap_begin };
+        relocate(m_array_ptr + m_gap_end, m_array_ptr + m_gap_end + distance, m_array_ptr + m_gap_begin);
+        m_gap_begin += distance;
+        m_gap_end += distance;
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::reserve(std::size_t capacity)
+{
+    if (capacity > m_capacity)
+    {
+        reallocate(capacity, m_gap_begin);
+    }
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::clear()
+{
+    destroyRange(m_array_ptr, m_array_ptr + m_gap_begin);
+    destroyRange(m_array_ptr + m_gap_end, m_array_ptr + m_capacity);
+    if (m_array_ptr) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+    m_array_ptr = nullptr;
+    m_capacity = 0;
+    m_gap_begin = 0;
+    m_gap_end = 0;
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::insert(int position, const T& value)
+{
+    emplace(position, value);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CustomGapArray<T, Allocator>::emplace(int position, Args&&... args)
+{
+    std::size_t length{ size() };
+    if (position < 0)
+    {
+        position = length ? static_cast<int>(length) - (abs(position) % static_cast<int>(length)) : 0;
+    }
+    std::size_t target{ (static_cast<std::size_t>(position) > length) ? length : static_cast<std::size_t>(position) };
+
+    if (m_gap_begin == m_gap_end)
+    {
+        // args may refer to an element of this array, so the element is constructed before the old memory is freed.
+        std::size_t new_capacity{ nextCapacity(length + 1) };
+        std::size_t after{ length - target };
+        T* new_array_ptr{ AllocTraits::allocate(m_allocator, new_capacity) };
+        T* inserted_ptr{ new_array_ptr + target };
+        T* after_ptr{ new_array_ptr + new_capacity - after };
+        try
+        {
+            AllocTraits::construct(m_allocator, inserted_ptr, std::forward<Args>(args)...);
+            try
+            {
+                constructMoves(m_array_ptr, m_array_ptr + target, new_array_ptr);
+                try
+                {
+                    constructMoves(m_array_ptr + target, m_array_ptr + length, after_ptr);
+                }
+                catch (...)
+                {
+                    destroyRange(new_array_ptr, inserted_ptr);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                destroyRange(inserted_ptr, inserted_ptr + 1);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            AllocTraits::deallocate(m_allocator, new_array_ptr, new_capacity);
+            throw;
+        }
+        destroyRange(m_array_ptr, m_array_ptr + m_capacity);
+        if (m_array_ptr) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+        m_array_ptr = new_array_ptr;
+        m_capacity = new_capacity;
+        m_gap_begin = target + 1;
+        m_gap_end = new_capacity - after;
+        return;
+    }
+
+    if (target != m_gap_begin)
+    {
+        // args may refer to an element that moveCursor would move, so the element is constructed first.
+        T temp(std::forward<Args>(args)...);
+        moveCursor(static_cast<int>(target));
+        AllocTraits::construct(m_allocator, m_array_ptr + m_gap_begin, std::move(temp));
+        ++m_gap_begin;
+        return;
+    }
+
+    AllocTraits::construct(m_allocator, m_array_ptr + m_gap_begin, std::forward<Args>(args)...);
+    ++m_gap_begin;
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::erase(int position)
+{
+    if (empty()) { return; }
+
+    std::size_t length{ size() };
+    if (position < 0)
+    {
+        position = static_cast<int>(length) - (abs(position) % static_cast<int>(length));
+    }
+    std::size_t target{ (static_cast<std::size_t>(position) >= length) ? length - 1 : static_cast<std::size_t>(position) };
+
+    if (target + 1 == m_gap_begin)
+    {
+        --m_gap_begin;
+        AllocTraits::destroy(m_allocator, m_array_ptr + m_gap_begin);
+        return;
+    }
+
+    moveCursor(static_cast<int>(target));
+    AllocTraits::destroy(m_allocator, m_array_ptr + m_gap_end);
+    ++m_gap_end;
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::pushBack(const T& value)
+{
+    emplace(static_cast<int>(size()), value);
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::pushBack(T&& value)
+{
+    emplace(static_cast<int>(size()), std::move(value));
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::popBack()
+{
+    erase(static_cast<int>(size()));
+}
+
+template <typename T, typename Allocator>
+int CustomGapArray<T, Allocator>::search(const T& value) const
+{
+    std::size_t position{ simdFind(static_cast<const T*>(m_array_ptr), m_gap_begin, value) };
+    if (position < m_gap_begin) { return static_cast<int>(position); }
+
+    std::size_t after{ m_capacity - m_gap_end };
+    position = simdFind(static_cast<const T*>(m_array_ptr + m_gap_end), after, value);
+    return (position < after) ? static_cast<int>(m_gap_begin + position) : -1;
+}
+
+template <typename T, typename Allocator>
+std::size_t CustomGapArray<T, Allocator>::count(const T& value) const
+{
+    return simdCount(static_cast<const T*>(m_array_ptr), m_gap_begin, value)
+         + simdCount(static_cast<const T*>(m_array_ptr + m_gap_end), m_capacity - m_gap_end, value);
+}
+
+template <typename T, typename Allocator>
+void CustomGapArray<T, Allocator>::swap(CustomGapArray<T, Allocator>& other)
+{
+    if (this == &other) { return; }
+
+    if (m_allocator == other.m_allocator)
+    {
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_gap_begin, other.m_gap_begin);
+        std::swap(m_gap_end, other.m_gap_end);
+        std::swap(m_array_ptr, other.m_array_ptr);
+        return;
+    }
+
+    CustomGapArray<T, Allocator> temp{ std::move(other) };
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+// Public member functions definitions end here.
+
+// Friend function definitions begin here.
+
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomGapArray<T, Allocator>& arr)
+{
+    return arr.display(out);
+}
+
+// Friend functions definitions end here.
+
+#endif // CUSTOMGAPARRAY_H_INCLUDED
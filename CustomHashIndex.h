@@ -0,0 +1,455 @@
+#ifndef CUSTOMHASHINDEX_H_INCLUDED
+#define CUSTOMHASHINDEX_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring>     // std::memset
+#include <functional>  // std::hash
+#include <utility>     // std::swap, std::move
+#include <memory>      // std::unique_ptr
+#include <cassert>
+#include "CustomArray.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomHashIndex.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a hash index that is attached to a CustomArray, in the form of a class
+ *   template CustomHashIndex. The index answers contains and indexOf in expected O(1), whether or not the
+ *   array is sorted, where CustomArray::search is O(n) on an unsorted array and O(log n) on a sorted one.
+ *
+ *   The index is an open addressing hash table of element positions, laid out in groups of 16 slots.
+ *   Each slot has a control byte, which is either empty or holds 7 bits of the hash of the element in the
+ *   slot. A lookup compares the 7 bits of the value's hash with all 16 control bytes of a group at once
+ *   using simdMatchBytes16, and only compares the value with the elements whose bits match, so nearly every
+ *   lookup compares one element. A group with an empty slot ends the lookup.
+ *
+ *   The index remembers the revision of the array it was built from. Every lookup checks the revision,
+ *   and rebuilds the table first if the array has changed since.
+ *   For arrays that rarely change, the rebuild cost is paid once for many lookups.
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomHashIndex
+ *
+ *   Purpose:
+ *
+ *     An open addressing hash index of the positions of the elements of a CustomArray.
+ *
+ *   Member Variables:
+ *
+ *     m_array_ptr
+ *       A pointer to the array the index is attached to, or nullptr.
+ *     m_revision
+ *       The revision of the array when the table was built.
+ *     m_built
+ *       A bool True if the table has been built since the index was attached.
+ *     m_group_count
+ *       An unsigned integer (std::size_t) that tracks the number of groups of 16 slots. A power of two.
+ *     m_control
+ *       An array specialised unique pointer holding one control byte per slot.
+ *     m_positions
+ *       An array specialised unique pointer holding the array position of the element in each full slot.
+ *     m_hash
+ *       A Hash object that hashes elements.
+ *
+ *   Member Functions:
+ *
+ *     hashOf
+ *       Returns the mixed hash of a value.
+ *     probe
+ *       Finds the slot of a value, or the slot where it would be stored.
+ *     ensureCurrent
+ *       Rebuilds the table if the array has changed since it was built.
+ *     rebuild
+ *       Builds the table from the elements of the array.
+ *     attach
+ *       Attaches the index to an array.
+ *     detach
+ *       Detaches the index from its array, and frees the table.
+ *     isAttached
+ *       Returns a bool True if the index is attached to an array.
+ *     isCurrent
+ *       Returns a bool True if the table matches the current elements of the array.
+ *     refresh
+ *       Rebuilds the table now, if the array has changed.
+ *     contains
+ *       Returns whether the array contains a specified value.
+ *     indexOf
+ *       Returns the position of the first element equal to a specified value.
+ *     swap
+ *       Swaps index data with another index.
+ *
+ */
+template <typename T, typename Allocator = std::allocator<T>, typename Hash = std::hash<T>>
+class CustomHashIndex
+{
+private:
+
+    // Each group holds groupWidth slots, which are matched with one simdMatchBytes16.
+    static constexpr std::size_t groupWidth{ 16 };
+
+    // The control byte of an empty slot. Full slots hold 7 bits of hash, so they never have the top bit set.
+    static constexpr std::uint8_t emptyControl{ 0x80 };
+
+    const CustomArray<T, Allocator>* m_array_ptr{};
+    mutable std::size_t m_revision{};
+    mutable bool m_built{};
+    mutable std::size_t m_group_count{};
+    mutable std::unique_ptr<std::uint8_t[]> m_control{};
+    mutable std::unique_ptr<std::uint32_t[]> m_positions{};
+    Hash m_hash{};
+
+    // Returns m_hash(value) multiplied by a large odd constant and folded, so that hashes which differ only
+    // in their high bits, such as the identity hash of integers, still spread over the groups.
+    std::uint64_t hashOf(const T& value) const;
+
+    /*
+     *
+     * bool probe(const T& value, std::uint64_t hash, std::size_t& slot) const;
+     *
+     * Summary:
+     *
+     *   Finds the slot of a value, or the slot where it would be stored.
+     *
+     * Parameters   : const T& value, std::uint64_t hash, std::size_t& slot
+     *
+     * Return Value : bool found
+     *
+     * Description:
+     *
+     *   Visits the groups in triangular order from the group chosen by the low bits of hash, which visits
+     *   every group once as the number of groups is a power of two. In each group, compares the top 7 bits of
+     *   hash with the 16 control bytes using simdMatchBytes16, and compares value with the element of each
+     *   matching slot. If an element is equal to value, sets slot to its slot and returns true.
+     *   Else, at the first group with an empty slot, sets slot to that empty slot and returns false.
+     *   The table is never more than 7/8 full, so there is always an empty slot.
+     *
+     */
+    bool probe(const T& value, std::uint64_t hash, std::size_t& slot) const;
+
+    // Rebuilds the table if it has not been built, or the revision of the array has changed.
+    void ensureCurrent() const { if (m_array_ptr && (!m_built || m_revision != m_array_ptr->revision())) { rebuild(); } }
+
+    /*
+     *
+     * void rebuild() const;
+     *
+     * Summary:
+     *
+     *   Builds the table from the elements of the array.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sizes the table to the smallest power of two number of groups that keeps it at most 7/8 full,
+     *   reusing the existing table if it is already that size. Inserts the position of each element in
+     *   order, skipping elements equal to one already inserted, so each value maps to its first position.
+     *   Records the revision of the array.
+     *
+     */
+    void rebuild() const;
+
+public:
+
+    // An overloaded default constructor that writes a message to the standard output. The index is detached.
+    CustomHashIndex() noexcept;
+
+    /*
+     *
+     * explicit CustomHashIndex(const CustomArray<T, Allocator>& array, const Hash& hash = Hash{});
+     *
+     * Summary:
+     *
+     *   Initialises an index attached to an array.
+     *
+     * Parameters: const CustomArray<T, Allocator>& array, const Hash& hash
+     *
+     * Description:
+     *
+     *   The table is built by the first lookup, not by the constructor. The array must outlive the index,
+     *   or the index must be detached or attached to another array first.
+     *
+     */
+    explicit CustomHashIndex(const CustomArray<T, Allocator>& array, const Hash& hash = Hash{});
+
+    // Copy constructor. The copy is attached to the same array, and builds its own table when first used.
+    CustomHashIndex(const CustomHashIndex<T, Allocator, Hash>& other);
+
+    // Move constructor. Takes the table of other, and leaves other detached.
+    CustomHashIndex(CustomHashIndex<T, Allocator, Hash>&& other) noexcept;
+
+    // A destructor that writes a message to the standard output.
+    ~CustomHashIndex() noexcept;
+
+    // Copy and move assignment operator overloads.
+    CustomHashIndex& operator=(const CustomHashIndex<T, Allocator, Hash>& other);
+    CustomHashIndex& operator=(CustomHashIndex<T, Allocator, Hash>&& other) noexcept;
+
+    // Public member function declarations.
+    bool isAttached() const { return m_array_ptr != nullptr; }
+    bool isCurrent() const { return m_array_ptr && m_built && m_revision == m_array_ptr->revision(); }
+
+    // Attaches the index to array. The table is rebuilt by the next lookup.
+    void attach(const CustomArray<T, Allocator>& array);
+
+    // Detaches the index from its array, and frees the table.
+    void detach();
+
+    /*
+     *
+     * void refresh() const;
+     *
+     * Summary:
+     *
+     *   Rebuilds the table now, if the array has changed.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Lookups rebuild the table themselves when needed, but a lookup that rebuilds changes the index, so
+     *   concurrent lookups are only safe on a current index. Call refresh after changing the array and before
+     *   sharing the index between threads. Also useful to move the rebuild cost out of a time critical loop.
+     *
+     */
+    void refresh() const { ensureCurrent(); }
+
+    /*
+     *
+     * int indexOf(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Returns the position of the first element equal to a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : int position or -1.
+     *
+     * Description:
+     *
+     *   Returns the position in the array of the first element equal to value, or -1 if there is none or
+     *   the index is detached. Rebuilds the table first if the array has changed. Expected O(1).
+     *   Elements must be comparable with == and hashed consistently with it by Hash.
+     *
+     */
+    int indexOf(const T& value) const;
+
+    // Returns whether an element of the array is equal to value. Expected O(1).
+    bool contains(const T& value) const { return indexOf(value) >= 0; }
+
+    // Swaps the arrays, tables and hash functions of two indexes.
+    void swap(CustomHashIndex<T, Allocator, Hash>& other);
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T, typename Allocator, typename Hash>
+std::uint64_t CustomHashIndex<T, Allocator, Hash>::hashOf(const T& value) const
+{
+    std::uint64_t hash{ static_cast<std::uint64_t>(m_hash(value)) * 0x9E3779B97F4A7C15ull };
+    return hash ^ (hash >> 32);
+}
+
+template <typename T, typename Allocator, typename Hash>
+bool CustomHashIndex<T, Allocator, Hash>::probe(const T& value, std::uint64_t hash, std::size_t& slot) const
+{
+    const T* elements{ m_array_ptr->data() };
+    std::uint8_t tag{ static_cast<std::uint8_t>(hash >> 57) };
+    std::size_t mask{ m_group_count - 1 };
+    std::size_t group{ static_cast<std::size_t>(hash) & mask };
+    for (std::size_t step{ 1 }; ; ++step)
+    {
+        const std::uint8_t* control{ m_control.get() + group * groupWidth };
+        for (unsigned match{ simdMatchBytes16(control, tag) }; match; match &= match - 1)
+        {
+            std::size_t candidate{ group * groupWidth + simdLowestBit(match) };
+            if (elements[m_positions[candidate]] == value)
+            {
+                slot = candidate;
+                return true;
+            }
+        }
+        unsigned empty{ simdMatchBytes16(control, emptyControl) };
+        if (empty)
+        {
+            slot = group * groupWidth + simdLowestBit(empty);
+            return false;
+        }
+        group = (group + step) & mask;
+    }
+}
+
+template <typename T, typename Allocator, typename Hash>
+void CustomHashIndex<T, Allocator, Hash>::rebuild() const
+{
+    std::size_t length{ m_array_ptr->size() };
+    assert(length <= 0xFFFFFFFFu && "CustomHashIndex stores positions in 32 bits.");
+
+    // The smallest power of two number of groups with at least length * 8 / 7 slots.
+    std::size_t group_count{ 1 };
+    while (group_count * groupWidth * 7 < length * 8)
+    {
+        group_count *= 2;
+    }
+    if (group_count != m_group_count || !m_control)
+    {
+        m_control.reset(new std::uint8_t[group_count * groupWidth]);
+        m_positions.reset(new std::uint32_t[group_count * groupWidth]);
+        m_group_count = group_count;
+    }
+    std::memset(m_control.get(), emptyControl, m_group_count * groupWidth);
+
+    const T* elements{ m_array_ptr->data() };
+    for (std::size_t position{ 0 }; position < length; ++position)
+    {
+        std::uint64_t hash{ hashOf(elements[position]) };
+        std::size_t slot{};
+        if (!probe(elements[position], hash, slot))
+        {
+            m_control[slot] = static_cast<std::uint8_t>(hash >> 57);
+            m_positions[slot] = static_cast<std::uint32_t>(position);
+        }
+    }
+    m_revision = m_array_ptr->revision();
+    m_built = true;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>::CustomHashIndex() noexcept
+{
+    std::cout << "CustomHashIndex default constructor called.\n";
+}
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>::CustomHashIndex(const CustomArray<T, Allocator>& array, const Hash& hash)
+    : m_array_ptr{ &array }, m_hash{ hash }
+{
+    std::cout << "CustomHashIndex (array) constructor called.\n";
+}
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>::CustomHashIndex(const CustomHashIndex<T, Allocator, Hash>& other)
+    : m_array_ptr{ other.m_array_ptr }, m_hash{ other.m_hash }
+{
+    std::cout << "CustomHashIndex copy constructor called.\n";
+}
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>::CustomHashIndex(CustomHashIndex<T, Allocator, Hash>&& other) noexcept
+    : m_array_ptr{ other.m_array_ptr }
+    , m_revision{ other.m_revision }
+    , m_built{ other.m_built }
+    , m_group_count{ other.m_group_count }
+    , m_control{ std::move(other.m_control) }
+    , m_positions{ std::move(other.m_positions) }
+    , m_hash{ std::move(other.m_hash) }
+{
+    std::cout << "CustomHashIndex move constructor called.\n";
+    other.detach();
+}
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>::~CustomHashIndex() noexcept
+{
+    std::cout << "CustomHashIndex destructor called.\n";
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>& CustomHashIndex<T, Allocator, Hash>::operator=(const CustomHashIndex<T, Allocator, Hash>& other)
+{
+    if (this != &other)
+    {
+        m_hash = other.m_hash;
+        if (other.m_array_ptr)
+        {
+            attach(*other.m_array_ptr);
+        }
+        else
+        {
+            detach();
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename Hash>
+CustomHashIndex<T, Allocator, Hash>& CustomHashIndex<T, Allocator, Hash>::operator=(CustomHashIndex<T, Allocator, Hash>&& other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, typename Allocator, typename Hash>
+void CustomHashIndex<T, Allocator, Hash>::attach(const CustomArray<T, Allocator>& array)
+{
+    m_array_ptr = &array;
+    m_built = false;
+}
+
+template <typename T, typename Allocator, typename Hash>
+void CustomHashIndex<T, Allocator, Hash>::detach()
+{
+    m_array_ptr = nullptr;
+    m_built = false;
+    m_group_count = 0;
+    m_control.reset(nullptr);
+    m_positions.reset(nullptr);
+}
+
+template <typename T, typename Allocator, typename Hash>
+int CustomHashIndex<T, Allocator, Hash>::indexOf(const T& value) const
+{
+    if (!m_array_ptr) { return -1; }
+
+    ensureCurrent();
+    std::size_t slot{};
+    return probe(value, hashOf(value), slot) ? static_cast<int>(m_positions[slot]) : -1;
+}
+
+template <typename T, typename Allocator, typename Hash>
+void CustomHashIndex<T, Allocator, Hash>::swap(CustomHashIndex<T, Allocator, Hash>& other)
+{
+    std::swap(m_array_ptr, other.m_array_ptr);
+    std::swap(m_revision, other.m_revision);
+    std::swap(m_built, other.m_built);
+    std::swap(m_group_count, other.m_group_count);
+    m_control.swap(other.m_control);
+    m_positions.swap(other.m_positions);
+    std::swap(m_hash, other.m_hash);
+}
+
+// Public member functions definitions end here.
+
+#endif // CUSTOMHASHINDEX_H_INCLUDED
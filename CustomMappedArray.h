@@ -0,0 +1,680 @@
+#ifndef CUSTOMMAPPEDARRAY_H_INCLUDED
+#define CUSTOMMAPPEDARRAY_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memset
+#include <cerrno>       // errno
+#include <utility>      // std::swap
+#include <type_traits>  // std::is_trivially_copyable
+#include <stdexcept>    // std::runtime_error, std::logic_error
+#include <system_error> // std::system_error
+#include <fcntl.h>      // open
+#include <unistd.h>     // close, ftruncate, sysconf
+#include <sys/mman.h>   // mmap, mremap, munmap, msync, madvise
+#include <sys/stat.h>   // fstat
+#include "CustomArray.h"
+#include "CustomArrayFile.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomMappedArray.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for an array container backed by a memory-mapped file, in the form of a class
+ *   template CustomMappedArray.
+ *
+ *   The elements are stored in the file in the same layout as in memory, after a CustomArrayFileHeader.
+ *   This is the binary file format of CustomArrayFile.h, so a file written by saveBinary can be opened directly.
+ *   The operating system pages the elements in and out of memory as they are used, so the array can be
+ *   larger than the physical memory, and reopening a file restores the array without reading or parsing it.
+ *   The file grows with ftruncate, and the mapping with mremap where it is available.
+ *
+ *   Elements must be trivially copyable, as they are written to the file as they are in memory.
+ *   A file can only be read on a machine with the same byte order as the one that wrote it.
+ *   Requires a POSIX operating system.
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomMappedArray
+ *
+ *   Purpose:
+ *
+ *     An array container class template whose elements are stored in a memory-mapped file.
+ *
+ *   Member Variables:
+ *
+ *     m_fd
+ *       The file descriptor of the open file, or -1.
+ *     m_map_ptr
+ *       A pointer to the first byte of the mapping, which holds the file header.
+ *     m_map_bytes
+ *       The number of bytes mapped, a whole number of pages.
+ *     m_file_bytes
+ *       The size of the file. The mapping may extend past it to the end of the last page.
+ *     m_capacity
+ *       The number of elements the mapped file can hold.
+ *     m_array_ptr
+ *       A pointer to the first element, immediately after the file header.
+ *
+ *   Member Functions:
+ *
+ *     header
+ *       Returns the file header at the start of the mapping.
+ *     fail
+ *       Closes the file and throws a std::system_error for the last operating system error.
+ *     remap
+ *       Resizes the file and the mapping to hold the specified number of elements.
+ *     pageBytes
+ *       Returns the size of a memory page.
+ *     size
+ *       Returns the number of elements, stored in the file header.
+ *     empty
+ *       Returns a bool True if the array has no elements.
+ *     capacity
+ *       Returns m_capacity
+ *     data
+ *       Returns a pointer to the first element.
+ *     reserve
+ *       Grows the file to hold at least the specified number of elements.
+ *     shrinkToFit
+ *       Shrinks the file to hold the current number of elements.
+ *     clear
+ *       Removes every element, keeping the file size.
+ *     resize
+ *       Sets the number of elements. New elements are zero.
+ *     pushBack
+ *       Appends a new value to the end of the array.
+ *     popBack
+ *       Removes an existing value from the end of the array.
+ *     sort
+ *       Sorts the array in ascending order, or by a comparison function, in O(n log n).
+ *     isSorted
+ *       Function to state whether the array elements are in ascending order or not.
+ *     search
+ *       Searches the array for a specified value.
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     advise
+ *       Tells the operating system how the elements are about to be accessed.
+ *     sync
+ *       Writes any changed elements to the file, and waits for the writes to finish.
+ *     swap
+ *       Swaps the mapped files of two arrays.
+ *
+ */
+template <typename T>
+class CustomMappedArray
+{
+private:
+
+    static_assert(std::is_trivially_copyable<T>::value, "CustomMappedArray requires a trivially copyable element type.");
+    static_assert(alignof(T) <= sizeof(CustomArrayFileHeader), "CustomMappedArray element alignment is too large.");
+
+    int m_fd{ -1 };
+    unsigned char* m_map_ptr{};
+    std::size_t m_map_bytes{};
+    std::size_t m_file_bytes{};
+    std::size_t m_capacity{};
+    T* m_array_ptr{};
+
+    CustomArrayFileHeader& header() const { return *reinterpret_cast<CustomArrayFileHeader*>(m_map_ptr); }
+
+    // Closes the file, and throws a std::system_error describing errno and the operation that failed.
+    [[noreturn]] void fail(const char* operation);
+
+    /*
+     *
+     * void remap(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Resizes the file and the mapping to hold the specified number of elements.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Maps the header plus capacity elements, rounded up to whole pages. If the file cannot hold capacity
+     *   elements, grows it to the mapped size using ftruncate. A file that is already long enough is left unchanged,
+     *   and the capacity is limited to the elements it holds, as the mapping past its end is not saved.
+     *   The mapping is resized with mremap on Linux, which may move it without copying the elements.
+     *   Elsewhere, the file is unmapped and mapped again.
+     *   Pointers and references to elements are invalidated.
+     *
+     */
+    void remap(std::size_t capacity);
+
+    static std::size_t pageBytes();
+
+public:
+
+    // Access patterns for advise, passed on to madvise.
+    enum class Access { normal, sequential, random, willNeed, dontNeed };
+
+    // An overloaded default constructor that writes a message to the standard output. No file is open.
+    CustomMappedArray() noexcept;
+
+    /*
+     *
+     * explicit CustomMappedArray(const char* path);
+     *
+     * Summary:
+     *
+     *   Opens or creates a file at path, and maps it into memory.
+     *
+     * Parameters: const char* path
+     *
+     * Description:
+     *
+     *   If the file exists, checks its header and maps the elements it holds, without reading them.
+     *   Else, creates the file with a header and no elements.
+     *   Throws std::system_error if the file cannot be opened or mapped, and std::runtime_error if the file
+     *   is not a CustomMappedArray file of element type T.
+     *
+     */
+    explicit CustomMappedArray(const char* path);
+
+    // The mapped file has a single owner, so arrays can be moved but not copied.
+    CustomMappedArray(const CustomMappedArray<T>& other) = delete;
+    CustomMappedArray(CustomMappedArray<T>&& other) noexcept;
+
+    /*
+     *
+     * ~CustomMappedArray() noexcept;
+     *
+     * Summary:
+     *
+     *   Writes the elements to the file and closes it.
+     *
+     * Description:
+     *
+     *   Shrinks the file to the number of elements using shrinkToFit, so that it holds no unused capacity,
+     *   then unmaps and closes it. A file that already ends after the last element is not truncated. The operating system writes any changed pages to the file.
+     *
+     */
+    ~CustomMappedArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_map_ptr ? static_cast<std::size_t>(header().m_length) : 0; }
+    bool empty() const { return !size(); }
+    std::size_t capacity() const { return m_capacity; }
+    T* data() { return m_array_ptr; }
+    const T* data() const { return m_array_ptr; }
+
+    /*
+     *
+     * void reserve(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Grows the file to hold at least the specified number of elements.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If capacity is greater than the current capacity, grows the file and the mapping using remap.
+     *   The new part of the file reads as zero, and uses no disk space until it is written.
+     *
+     */
+    void reserve(std::size_t capacity);
+
+    void shrinkToFit();
+    void clear();
+
+    // Sets the number of elements, growing the file if needed. New elements are zero bytes.
+    // Throws std::logic_error if no file is open.
+    void resize(std::size_t length);
+
+    // Appends value to the end of the array. The file grows geometrically, so this is amortised O(1).
+    // Throws std::logic_error if no file is open.
+    void pushBack(const T& value);
+    void popBack();
+
+    /*
+     *
+     * void sort();
+     * template <typename Compare>
+     * void sort(Compare comp);
+     *
+     * Summary:
+     *
+     *   Sorts the array in ascending order, or by a comparison function, in O(n log n).
+     *
+     * Parameters   : Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sorts the elements in the mapping using the pattern-defeating quicksort of CustomArray.
+     *
+     */
+    void sort();
+    template <typename Compare>
+    void sort(Compare comp);
+
+    bool isSorted() const;
+
+    // Returns the position of the first element equal to value, or -1, searching with simdFind.
+    int search(const T& value) const;
+
+    // Returns the number of elements equal to value, using simdCount.
+    std::size_t count(const T& value) const;
+
+    /*
+     *
+     * void advise(Access access);
+     *
+     * Summary:
+     *
+     *   Tells the operating system how the elements are about to be accessed.
+     *
+     * Parameters   : Access access
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls madvise on the mapping. Access::sequential reads ahead aggressively and drops pages soon after
+     *   they are used, for a single pass over the array. Access::random disables read ahead, for searches.
+     *   Access::willNeed starts reading the whole array in the background, and Access::dontNeed releases it.
+     *   The advice is only a hint, and errors are ignored.
+     *
+     */
+    void advise(Access access);
+
+    /*
+     *
+     * void sync();
+     *
+     * Summary:
+     *
+     *   Writes any changed elements to the file, and waits for the writes to finish.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Calls msync with MS_SYNC on the mapping, so that the elements and length are on disk if the
+     *   process or machine stops afterwards. Throws std::system_error if the writes fail.
+     *
+     */
+    void sync();
+
+    void swap(CustomMappedArray<T>& other);
+
+    // Index operator overloads. Support negative indexing!
+    T& operator[](int position);
+    const T& operator[](int position) const;
+
+    // Move assignment operator overload. Closes the current file, and takes the file of other.
+    CustomMappedArray& operator=(CustomMappedArray<T>&& other) noexcept;
+    CustomMappedArray& operator=(const CustomMappedArray<T>& other) = delete;
+
+    // The iterators of CustomArray, so that code written for either array works with both.
+    using Iterator = typename CustomArray<T>::Iterator;
+    using ConstIterator = typename CustomArray<T>::ConstIterator;
+
+    Iterator begin() { return Iterator{ m_array_ptr }; }
+    Iterator end() { return Iterator{ m_array_ptr + size() }; }
+    ConstIterator begin() const { return ConstIterator{ m_array_ptr }; }
+    ConstIterator end() const { return ConstIterator{ m_array_ptr + size() }; }
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T>
+void CustomMappedArray<T>::fail(const char* operation)
+{
+    int error{ errno };
+    if (m_map_ptr) { munmap(m_map_ptr, m_map_bytes); }
+    if (m_fd >= 0) { close(m_fd); }
+    m_fd = -1;
+    m_map_ptr = nullptr;
+    m_map_bytes = 0;
+    m_file_bytes = 0;
+    m_capacity = 0;
+    m_array_ptr = nullptr;
+    throw std::system_error(error, std::generic_category(), operation);
+}
+
+template <typename T>
+std::size_t CustomMappedArray<T>::pageBytes()
+{
+    static const std::size_t bytes{ static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) };
+    return bytes;
+}
+
+template <typename T>
+void CustomMappedArray<T>::remap(std::size_t capacity)
+{
+    std::size_t page{ pageBytes() };
+    std::size_t bytes{ (sizeof(CustomArrayFileHeader) + capacity * sizeof(T) + page - 1) / page * page };
+    if (sizeof(CustomArrayFileHeader) + capacity * sizeof(T) > m_file_bytes)
+    {
+        if (ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) { fail("ftruncate"); }
+        m_file_bytes = bytes;
+    }
+
+    void* map_ptr{ MAP_FAILED };
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    if (m_map_ptr)
+    {
+        map_ptr = mremap(m_map_ptr, m_map_bytes, bytes, MREMAP_MAYMOVE);
+    }
+    else
+#endif
+    {
+        if (m_map_ptr) { munmap(m_map_ptr, m_map_bytes); }
+        m_map_ptr = nullptr;
+        map_ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    }
+    if (map_ptr == MAP_FAILED) { fail("mmap"); }
+
+    m_map_ptr = static_cast<unsigned char*>(map_ptr);
+    m_map_bytes = bytes;
+    m_capacity = (((bytes < m_file_bytes) ? bytes : m_file_bytes) - sizeof(CustomArrayFileHeader)) / sizeof(T);
+    m_array_ptr = reinterpret_cast<T*>(m_map_ptr + sizeof(CustomArrayFileHeader));
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T>
+CustomMappedArray<T>::CustomMappedArray() noexcept
+{
+    std::cout << "CustomMappedArray default constructor called.\n";
+}
+
+template <typename T>
+CustomMappedArray<T>::CustomMappedArray(const char* path)
+{
+    std::cout << "CustomMappedArray (file) constructor called.\n";
+    m_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) { fail("open"); }
+
+    struct stat status{};
+    if (fstat(m_fd, &status) != 0) { fail("fstat"); }
+    std::size_t file_bytes{ static_cast<std::size_t>(status.st_size) };
+
+    if (file_bytes == 0)
+    {
+        remap(0);
+        customArrayMakeHeader<T>(header(), 0);
+        return;
+    }
+
+    CustomArrayFileHeader file_header{};
+    if (file_bytes < sizeof(file_header) || pread(m_fd, &file_header, sizeof(file_header), 0) != sizeof(file_header)
+        || !customArrayCheckHeader<T>(file_header)
+        || file_header.m_length > (file_bytes - sizeof(file_header)) / sizeof(T))
+    {
+        close(m_fd);
+        m_fd = -1;
+        throw std::runtime_error("CustomMappedArray: not an array file of this element type.");
+    }
+
+    // The capacity is whatever the file holds after the elements, so mapping it reads nothing from disk.
+    m_file_bytes = file_bytes;
+    remap((file_bytes - sizeof(file_header)) / sizeof(T));
+
+    // The elements may be changed through the mapping, so any checksum from the binary file format is cleared.
+    // It is only written if set, so that opening a file does not change it.
+    if (header().m_checksum != 0) { header().m_checksum = 0; }
+}
+
+template <typename T>
+CustomMappedArray<T>::CustomMappedArray(CustomMappedArray<T>&& other) noexcept
+    : m_fd{ other.m_fd }
+    , m_map_ptr{ other.m_map_ptr }
+    , m_map_bytes{ other.m_map_bytes }
+    , m_file_bytes{ other.m_file_bytes }
+    , m_capacity{ other.m_capacity }
+    , m_array_ptr{ other.m_array_ptr }
+{
+    std::cout << "CustomMappedArray move constructor called.\n";
+    other.m_fd = -1;
+    other.m_map_ptr = nullptr;
+    other.m_map_bytes = 0;
+    other.m_file_bytes = 0;
+    other.m_capacity = 0;
+    other.m_array_ptr = nullptr;
+}
+
+template <typename T>
+CustomMappedArray<T>::~CustomMappedArray() noexcept
+{
+    std::cout << "CustomMappedArray destructor called.\n";
+    if (m_map_ptr)
+    {
+        try
+        {
+            shrinkToFit();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Standard exception caught: " << e.what() << "\n";
+        }
+    }
+    if (m_map_ptr) { munmap(m_map_ptr, m_map_bytes); }
+    if (m_fd >= 0) { close(m_fd); }
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T>
+T& CustomMappedArray<T>::operator[](int position)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return m_array_ptr[position];
+}
+
+template <typename T>
+const T& CustomMappedArray<T>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return m_array_ptr[position];
+}
+
+template <typename T>
+CustomMappedArray<T>& CustomMappedArray<T>::operator=(CustomMappedArray<T>&& other) noexcept
+{
+    CustomMappedArray<T> temp{ static_cast<CustomMappedArray<T>&&>(other) };
+    swap(temp);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T>
+void CustomMappedArray<T>::reserve(std::size_t capacity)
+{
+    if (m_map_ptr && capacity > m_capacity)
+    {
+        remap(capacity);
+    }
+}
+
+template <typename T>
+void CustomMappedArray<T>::shrinkToFit()
+{
+    std::size_t length{ size() };
+    std::size_t file_bytes{ sizeof(CustomArrayFileHeader) + length * sizeof(T) };
+    if (m_map_ptr && m_file_bytes != file_bytes)
+    {
+        // The file ends exactly after the last element, and the mapping keeps the page it ends in.
+        remap(length);
+        if (ftruncate(m_fd, static_cast<off_t>(file_bytes)) != 0)
+        {
+            fail("ftruncate");
+        }
+        m_file_bytes = file_bytes;
+        m_capacity = length;
+    }
+}
+
+template <typename T>
+void CustomMappedArray<T>::clear()
+{
+    if (m_map_ptr) { header().m_length = 0; }
+}
+
+template <typename T>
+void CustomMappedArray<T>::resize(std::size_t length)
+{
+    if (!m_map_ptr) { throw std::logic_error("CustomMappedArray: resize with no file open."); }
+
+    reserve(length);
+    if (length > size())
+    {
+        std::memset(static_cast<void*>(m_array_ptr + size()), 0, (length - size()) * sizeof(T));
+    }
+    header().m_length = length;
+}
+
+template <typename T>
+void CustomMappedArray<T>::pushBack(const T& value)
+{
+    if (!m_map_ptr) { throw std::logic_error("CustomMappedArray: pushBack with no file open."); }
+
+    std::size_t length{ size() };
+    if (length == m_capacity)
+    {
+        // value may refer to an element of this array, so it is copied before the mapping moves.
+        T temp(value);
+        remap((m_capacity > 0) ? m_capacity * 2 : 1);
+        m_array_ptr[length] = temp;
+    }
+    else
+    {
+        m_array_ptr[length] = value;
+    }
+    header().m_length = length + 1;
+}
+
+template <typename T>
+void CustomMappedArray<T>::popBack()
+{
+    if (!empty()) { header().m_length = size() - 1; }
+}
+
+template <typename T>
+void CustomMappedArray<T>::sort()
+{
+    sort([](const T& a, const T& b) { return a < b; });
+}
+
+template <typename T>
+template <typename Compare>
+void CustomMappedArray<T>::sort(Compare comp)
+{
+    std::size_t length{ size() };
+    if (length < 2) { return; }
+
+    // badAllowed is log2(n), the number of unbalanced partitions tolerated before falling back to heapSort.
+    int badAllowed{ 0 };
+    for (std::size_t remaining{ length }; remaining > 1; remaining >>= 1)
+    {
+        ++badAllowed;
+    }
+    CustomArray<T>::pdqSort(m_array_ptr, m_array_ptr + length, comp, badAllowed, true);
+}
+
+template <typename T>
+bool CustomMappedArray<T>::isSorted() const
+{
+    std::size_t length{ size() };
+    for (std::size_t position{ 1 }; position < length; ++position)
+    {
+        if (m_array_ptr[position - 1] > m_array_ptr[position])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+template <typename T>
+int CustomMappedArray<T>::search(const T& value) const
+{
+    std::size_t position{ simdFind(m_array_ptr, size(), value) };
+    return (position < size()) ? static_cast<int>(position) : -1;
+}
+
+template <typename T>
+std::size_t CustomMappedArray<T>::count(const T& value) const
+{
+    return simdCount(m_array_ptr, size(), value);
+}
+
+template <typename T>
+void CustomMappedArray<T>::advise(Access access)
+{
+    if (!m_map_ptr) { return; }
+
+    int advice{ MADV_NORMAL };
+    switch (access)
+    {
+    case Access::normal:     advice = MADV_NORMAL; break;
+    case Access::sequential: advice = MADV_SEQUENTIAL; break;
+    case Access::random:     advice = MADV_RANDOM; break;
+    case Access::willNeed:   advice = MADV_WILLNEED; break;
+    case Access::dontNeed:   advice = MADV_DONTNEED; break;
+    }
+    madvise(m_map_ptr, m_map_bytes, advice);
+}
+
+template <typename T>
+void CustomMappedArray<T>::sync()
+{
+    if (m_map_ptr && msync(m_map_ptr, m_map_bytes, MS_SYNC) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "msync");
+    }
+}
+
+template <typename T>
+void CustomMappedArray<T>::swap(CustomMappedArray<T>& other)
+{
+    std::swap(m_fd, other.m_fd);
+    std::swap(m_map_ptr, other.m_map_ptr);
+    std::swap(m_map_bytes, other.m_map_bytes);
+    std::swap(m_file_bytes, other.m_file_bytes);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_array_ptr, other.m_array_ptr);
+}
+
+// Public member functions definitions end here.
+
+#endif // CUSTOMMAPPEDARRAY_H_INCLUDED
@@ -0,0 +1,773 @@
+#ifndef CUSTOMSEGMENTEDARRAY_H_INCLUDED
+#define CUSTOMSEGMENTEDARRAY_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <utility>     // std::swap, std::move, std::forward, std::initializer_list
+#include <iterator>    // std::bidirectional_iterator_tag
+#include <memory>      // std::allocator, std::allocator_traits
+#include <type_traits> // std::is_trivially_destructible
+#include "CustomArrayView.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomSegmentedArray.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a segmented array container, in the form of a class template CustomSegmentedArray.
+ *
+ *   The elements are stored in chunks of 2^ChunkShift elements, and a directory holds a pointer to each chunk.
+ *   Element i is element (i & (2^ChunkShift - 1)) of chunk (i >> ChunkShift), so random access is a shift,
+ *   a mask and two loads. When the last chunk is full, a new chunk is allocated and the directory grows if
+ *   needed, so appending never moves an element. Pointers, references and iterators to elements stay valid
+ *   until the element is removed, and growing never needs memory for a second copy of the elements.
+ *
+ *   Iterators move through one chunk with a pointer increment, and step to the next chunk at its end, so
+ *   iteration runs at nearly the speed of a contiguous array. chunk returns a CustomArrayView of one chunk
+ *   for the SIMD functions of CustomArrayView.
+ *
+ */
+
+
+// Forward declarations of class template CustomSegmentedArray and associated friend functions begin here.
+// Required to support class template functionality.
+
+
+/*
+ *
+ *   Class Name: CustomSegmentedArray
+ *
+ *   Purpose:
+ *
+ *     A custom array container class template that stores elements in fixed size chunks, which never move.
+ *
+ *   Member Variables:
+ *
+ *     m_length
+ *       An unsigned integer (std::size_t) that tracks the number of elements in the array.
+ *     m_chunk_count
+ *       An unsigned integer (std::size_t) that tracks the number of allocated chunks.
+ *     m_directory_capacity
+ *       An unsigned integer (std::size_t) that tracks the number of chunk pointers the directory can hold.
+ *     m_directory
+ *       A pointer to the directory, an array of pointers to the chunks. The slots after the last chunk are
+ *       null, and there is always at least one of them, so an iterator can step past the last chunk.
+ *     m_allocator
+ *       An Allocator object that allocates and deallocates the chunks.
+ *     m_directory_allocator
+ *       The Allocator, rebound to T*, that allocates and deallocates the directory.
+ *
+ *   Member Functions:
+ *
+ *     growDirectory
+ *       Makes the directory large enough for a number of chunks.
+ *     allocateChunks
+ *       Allocates chunks until there are at least a number of them.
+ *     destroyRange
+ *       Destroys the elements at a range of positions.
+ *     display
+ *       Prints the array data to the specified output stream.
+ *     size
+ *       Returns m_length
+ *     empty
+ *       Returns a bool True if the array has no elements.
+ *     capacity
+ *       Returns the number of elements the allocated chunks can hold.
+ *     chunkSize
+ *       Returns the number of elements in a chunk.
+ *     chunkCount
+ *       Returns the number of chunks that hold elements.
+ *     chunk
+ *       Returns a view of the elements of one chunk.
+ *     reserve
+ *       Allocates chunks for at least the specified number of elements.
+ *     shrinkToFit
+ *       Frees the chunks that hold no elements.
+ *     clear
+ *       Removes the array data from memory and the array.
+ *     resize
+ *       Resize function. All elements are kept in the array up to the new length.
+ *     pushBack
+ *       Appends a new value to the end of the array.
+ *     emplaceBack
+ *       Constructs a new element in place at the end of the array.
+ *     popBack
+ *       Removes an existing value from the end of the array.
+ *     search
+ *       Searches the array for a specified value.
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     swap
+ *       Swaps array data with another array.
+ *
+ */
+template <typename T, std::size_t ChunkShift = 12, typename Allocator = std::allocator<T>>
+class CustomSegmentedArray;
+
+/*
+ *
+ * template <typename T, std::size_t ChunkShift, typename Allocator>
+ * std::ostream& operator<<(std::ostream& out, const CustomSegmentedArray<T, ChunkShift, Allocator>& arr);
+ *
+ * Summary:
+ *
+ *    Standard output operator overload for a CustomSegmentedArray array object.
+ *
+ * Return Value: None
+ *
+ * Description:
+ *
+ *   Standard output operator overload that has friend privileges within the CustomSegmentedArray class.
+ *   Calls the private member function display.
+ *
+ */
+template <typename T, std::size_t ChunkShift, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomSegmentedArray<T, ChunkShift, Allocator>& arr);
+
+
+// Forward declaration of template friend functions ends here.
+
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+class CustomSegmentedArray
+{
+private:
+
+    static_assert(ChunkShift > 0 && ChunkShift < 31, "A chunk must hold between 2 and 2^30 elements.");
+
+    static constexpr std::size_t ChunkSize{ std::size_t{ 1 } << ChunkShift };
+    static constexpr std::size_t ChunkMask{ ChunkSize - 1 };
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using DirectoryAllocator = typename AllocTraits::template rebind_alloc<T*>;
+    using DirectoryTraits = std::allocator_traits<DirectoryAllocator>;
+    static_assert(std::is_same<typename AllocTraits::value_type, T>::value,
+                  "Allocator::value_type must be the same as the element type.");
+    static_assert(std::is_same<typename AllocTraits::pointer, T*>::value,
+                  "Allocator must allocate raw pointers.");
+
+    std::size_t m_length{};
+    std::size_t m_chunk_count{};
+    std::size_t m_directory_capacity{};
+    T** m_directory{};
+    Allocator m_allocator{};
+    DirectoryAllocator m_directory_allocator{};
+
+    /*
+     *
+     * void growDirectory(std::size_t chunks);
+     * void allocateChunks(std::size_t chunks);
+     *
+     * Summary:
+     *
+     *   Make room for a number of chunks, and allocate them.
+     *
+     * Parameters   : std::size_t chunks
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   growDirectory makes the directory hold at least chunks + 1 pointers, doubling its capacity, so only
+     *   the chunk pointers are copied. allocateChunks allocates chunks until there are at least chunks of them.
+     *   Neither moves an element. If an allocation throws, the chunks allocated before it are kept.
+     *
+     */
+    void growDirectory(std::size_t chunks);
+    void allocateChunks(std::size_t chunks);
+
+    // Destroys the elements at positions [first, last). Trivially destructible elements are left alone.
+    void destroyRange(std::size_t first, std::size_t last);
+
+    // Called by the overloaded operator << friend function.
+    std::ostream& display(std::ostream& out) const;
+
+    /*
+     *
+     *   Class Name: ChunkIterator
+     *
+     *   Purpose:
+     *
+     *     A bidirectional iterator over the elements of a CustomSegmentedArray, which steps through each chunk
+     *     with a pointer and moves to the next chunk through the directory at the end of each chunk.
+     *
+     */
+    template <typename Value>
+    class ChunkIterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+    private:
+        T* const* m_chunk_ptr;
+        pointer m_ptr;
+    public:
+        ChunkIterator(T* const* chunk = nullptr, pointer ptr = nullptr) : m_chunk_ptr{ chunk }, m_ptr{ ptr } {}
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        ChunkIterator& operator++()
+        {
+            if (++m_ptr == *m_chunk_ptr + ChunkSize) { m_ptr = *++m_chunk_ptr; }
+            return *this;
+        }
+        ChunkIterator operator++(int) { ChunkIterator temp{ *this }; ++(*this); return temp; }
+        ChunkIterator& operator--()
+        {
+            if (m_ptr == *m_chunk_ptr) { m_ptr = *--m_chunk_ptr + ChunkSize; }
+            --m_ptr;
+            return *this;
+        }
+        ChunkIterator operator--(int) { ChunkIterator temp{ *this }; --(*this); return temp; }
+        friend bool operator==(const ChunkIterator& a, const ChunkIterator& b) { return a.m_ptr == b.m_ptr; }
+        friend bool operator!=(const ChunkIterator& a, const ChunkIterator& b) { return a.m_ptr != b.m_ptr; }
+    };
+
+public:
+
+    using Iterator = ChunkIterator<T>;
+    using ConstIterator = ChunkIterator<const T>;
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomSegmentedArray() noexcept;
+
+    // Initialises an empty array that allocates its chunks with allocator.
+    explicit CustomSegmentedArray(const Allocator& allocator) noexcept;
+
+    // Initialises an array from a std::initializer_list.
+    CustomSegmentedArray(std::initializer_list<T> elements, const Allocator& allocator = Allocator{}) noexcept;
+
+    // Initialises an array from another array, copying each element into new chunks.
+    CustomSegmentedArray(const CustomSegmentedArray<T, ChunkShift, Allocator>& other) noexcept;
+
+    // Initialises an array from another array, taking its chunks and directory. other is left empty.
+    CustomSegmentedArray(CustomSegmentedArray<T, ChunkShift, Allocator>&& other) noexcept;
+
+    // Initialises an array from two iterators that are compatible with containers in the standard library.
+    template <typename InputIterator>
+    CustomSegmentedArray(InputIterator first, InputIterator last, const Allocator& allocator = Allocator{}) noexcept;
+
+    // Destroys the elements, and frees the chunks and directory.
+    ~CustomSegmentedArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_length; }
+    bool empty() const { return !m_length; }
+    std::size_t capacity() const { return m_chunk_count << ChunkShift; }
+    static constexpr std::size_t chunkSize() { return ChunkSize; }
+    std::size_t chunkCount() const { return (m_length + ChunkMask) >> ChunkShift; }
+    Allocator getAllocator() const { return m_allocator; }
+
+    /*
+     *
+     * CustomArrayView<T> chunk(std::size_t index);
+     * CustomArrayView<const T> chunk(std::size_t index) const;
+     *
+     * Summary:
+     *
+     *   Returns a view of the elements of one chunk.
+     *
+     * Parameters   : std::size_t index
+     *
+     * Return Value : CustomArrayView<T> view
+     *
+     * Description:
+     *
+     *   Returns a view of the elements of chunk index, which is chunkSize() elements long, except for the
+     *   last chunk, which holds the remaining elements. index must be less than chunkCount().
+     *   Code that needs contiguous memory, such as the SIMD functions of CustomArrayView, runs on each chunk.
+     *
+     */
+    CustomArrayView<T> chunk(std::size_t index);
+    CustomArrayView<const T> chunk(std::size_t index) const;
+
+    /*
+     *
+     * void reserve(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Allocates chunks for at least the specified number of elements.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Allocates chunks until capacity elements fit, so the next appends do not allocate.
+     *   No element is moved, so no pointer or iterator is invalidated.
+     *
+     */
+    void reserve(std::size_t capacity);
+
+    // Frees the chunks that hold no elements. No element is moved.
+    void shrinkToFit();
+
+    // Destroys the elements and frees the chunks and directory.
+    void clear();
+
+    /*
+     *
+     * void resize(std::size_t length);
+     *
+     * Summary:
+     *
+     *   Resize function. All elements are kept in the array up to the new length.
+     *
+     * Parameters   : std::size_t length
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   New elements are value-initialised. Elements beyond the new length are destroyed, and their chunks
+     *   are kept for reuse. If an exception is caught, the elements constructed before it are kept.
+     *
+     */
+    void resize(std::size_t length);
+
+    // Appends value to the end of the array. O(1), and never moves an existing element.
+    void pushBack(const T& value);
+    void pushBack(T&& value);
+
+    // Constructs a new element from args at the end of the array. O(1), and never moves an existing element.
+    template <typename... Args>
+    void emplaceBack(Args&&... args);
+
+    // Removes the last element. Its chunk is kept for reuse.
+    void popBack();
+
+    /*
+     *
+     * int search(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Searches the array for a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : int position
+     *
+     * Description:
+     *
+     *   Returns the position of the first element equal to value, or -1 if no element is equal to value.
+     *   Searches each chunk in turn using simdFind.
+     *
+     */
+    int search(const T& value) const;
+
+    // Returns the number of elements equal to value, using simdCount on each chunk.
+    std::size_t count(const T& value) const;
+
+    // Swaps the directories of two arrays. No element is moved, so pointers and iterators follow their elements.
+    void swap(CustomSegmentedArray<T, ChunkShift, Allocator>& other);
+
+    // Index operator overloads, using a shift and a mask. Support negative indexing!
+    T& operator[](int position);
+    const T& operator[](int position) const;
+
+    // Copy assignment operator overload. Copies the elements of other.
+    CustomSegmentedArray& operator=(const CustomSegmentedArray<T, ChunkShift, Allocator>& other);
+
+    // Move assignment operator overload. Takes the chunks and directory of other.
+    CustomSegmentedArray& operator=(CustomSegmentedArray<T, ChunkShift, Allocator>&& other);
+
+    // Fully specialised template friend function declarations.
+    friend std::ostream& operator<<<T, ChunkShift, Allocator>(std::ostream& out, const CustomSegmentedArray<T, ChunkShift, Allocator>& arr);
+
+    Iterator begin() { return m_directory ? Iterator{ m_directory, m_directory[0] } : Iterator{}; }
+    Iterator end()
+    {
+        return m_directory ? Iterator{ m_directory + (m_length >> ChunkShift), m_directory[m_length >> ChunkShift] + (m_length & ChunkMask) }
+                           : Iterator{};
+    }
+    ConstIterator begin() const { return m_directory ? ConstIterator{ m_directory, m_directory[0] } : ConstIterator{}; }
+    ConstIterator end() const
+    {
+        return m_directory ? ConstIterator{ m_directory + (m_length >> ChunkShift), m_directory[m_length >> ChunkShift] + (m_length & ChunkMask) }
+                           : ConstIterator{};
+    }
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::growDirectory(std::size_t chunks)
+{
+    if (chunks < m_directory_capacity) { return; }
+
+    std::size_t new_capacity{ m_directory_capacity ? m_directory_capacity * 2 : 8 };
+    while (new_capacity <= chunks)
+    {
+        new_capacity *= 2;
+    }
+    T** new_directory{ DirectoryTraits::allocate(m_directory_allocator, new_capacity) };
+    for (std::size_t index{ 0 }; index < new_capacity; ++index)
+    {
+        new_directory[index] = (index < m_chunk_count) ? m_directory[index] : nullptr;
+    }
+    if (m_directory) { DirectoryTraits::deallocate(m_directory_allocator, m_directory, m_directory_capacity); }
+    m_directory = new_directory;
+    m_directory_capacity = new_capacity;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::allocateChunks(std::size_t chunks)
+{
+    if (chunks <= m_chunk_count) { return; }
+
+    growDirectory(chunks);
+    while (m_chunk_count < chunks)
+    {
+        m_directory[m_chunk_count] = AllocTraits::allocate(m_allocator, ChunkSize);
+        ++m_chunk_count;
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::destroyRange(std::size_t first, std::size_t last)
+{
+    if (std::is_trivially_destructible<T>::value) { return; }
+
+    for (; first != last; ++first)
+    {
+        AllocTraits::destroy(m_allocator, m_directory[first >> ChunkShift] + (first & ChunkMask));
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+std::ostream& CustomSegmentedArray<T, ChunkShift, Allocator>::display(std::ostream& out) const
+{
+    // Characters are printed as a string, without spaces.
+    const char* separator{ std::is_same<T, char>::value ? "" : " " };
+    bool first{ true };
+    for (const T& element : *this)
+    {
+        if (!first) { out << separator; }
+        out << element;
+        first = false;
+    }
+    return out;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray() noexcept
+{
+    std::cout << "CustomSegmentedArray default constructor called.\n";
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray(const Allocator& allocator) noexcept
+    : m_allocator{ allocator }, m_directory_allocator{ allocator }
+{
+    std::cout << "CustomSegmentedArray (allocator) constructor called.\n";
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray(std::initializer_list<T> elements,
+                                                                     const Allocator& allocator) noexcept
+    : m_allocator{ allocator }, m_directory_allocator{ allocator }
+{
+    std::cout << "CustomSegmentedArray list-initialised constructor called.\n";
+    reserve(elements.size());
+    for (const T& element : elements)
+    {
+        emplaceBack(element);
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray(const CustomSegmentedArray<T, ChunkShift, Allocator>& other) noexcept
+    : m_allocator{ AllocTraits::select_on_container_copy_construction(other.m_allocator) },
+      m_directory_allocator{ m_allocator }
+{
+    std::cout << "CustomSegmentedArray copy constructor called.\n";
+    reserve(other.m_length);
+    for (const T& element : other)
+    {
+        emplaceBack(element);
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray(CustomSegmentedArray<T, ChunkShift, Allocator>&& other) noexcept
+    : m_length{ other.m_length }, m_chunk_count{ other.m_chunk_count }, m_directory_capacity{ other.m_directory_capacity },
+      m_directory{ other.m_directory }, m_allocator{ std::move(other.m_allocator) },
+      m_directory_allocator{ std::move(other.m_directory_allocator) }
+{
+    std::cout << "CustomSegmentedArray move constructor called.\n";
+    other.m_length = 0;
+    other.m_chunk_count = 0;
+    other.m_directory_capacity = 0;
+    other.m_directory = nullptr;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+template <typename InputIterator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::CustomSegmentedArray(InputIterator first, InputIterator last,
+                                                                     const Allocator& allocator) noexcept
+    : m_allocator{ allocator }, m_directory_allocator{ allocator }
+{
+    std::cout << "CustomSegmentedArray (iterator) copy constructor called.\n";
+    while (first != last)
+    {
+        emplaceBack(*first);
+        ++first;
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>::~CustomSegmentedArray() noexcept
+{
+    std::cout << "CustomSegmentedArray destructor called.\n";
+    clear();
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+T& CustomSegmentedArray<T, ChunkShift, Allocator>::operator[](int position)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    std::size_t index{ static_cast<std::size_t>(position) };
+    return m_directory[index >> ChunkShift][index & ChunkMask];
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+const T& CustomSegmentedArray<T, ChunkShift, Allocator>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    std::size_t index{ static_cast<std::size_t>(position) };
+    return m_directory[index >> ChunkShift][index & ChunkMask];
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>&
+CustomSegmentedArray<T, ChunkShift, Allocator>::operator=(const CustomSegmentedArray<T, ChunkShift, Allocator>& other)
+{
+    if (this == &other) { return *this; }
+
+    // The chunks are kept, so copying into an array of the same size allocates nothing.
+    destroyRange(0, m_length);
+    m_length = 0;
+    reserve(other.m_length);
+    for (const T& element : other)
+    {
+        emplaceBack(element);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomSegmentedArray<T, ChunkShift, Allocator>&
+CustomSegmentedArray<T, ChunkShift, Allocator>::operator=(CustomSegmentedArray<T, ChunkShift, Allocator>&& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    if (!(m_allocator == other.m_allocator))
+    {
+        reserve(other.m_length);
+        for (T& element : other)
+        {
+            emplaceBack(std::move(element));
+        }
+        other.clear();
+        return *this;
+    }
+
+    m_length = other.m_length;
+    m_chunk_count = other.m_chunk_count;
+    m_directory_capacity = other.m_directory_capacity;
+    m_directory = other.m_directory;
+    other.m_length = 0;
+    other.m_chunk_count = 0;
+    other.m_directory_capacity = 0;
+    other.m_directory = nullptr;
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomArrayView<T> CustomSegmentedArray<T, ChunkShift, Allocator>::chunk(std::size_t index)
+{
+    std::size_t first{ index << ChunkShift };
+    return CustomArrayView<T>{ m_directory[index], (m_length - first < ChunkSize) ? m_length - first : ChunkSize };
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+CustomArrayView<const T> CustomSegmentedArray<T, ChunkShift, Allocator>::chunk(std::size_t index) const
+{
+    std::size_t first{ index << ChunkShift };
+    return CustomArrayView<const T>{ m_directory[index], (m_length - first < ChunkSize) ? m_length - first : ChunkSize };
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::reserve(std::size_t capacity)
+{
+    allocateChunks((capacity + ChunkMask) >> ChunkShift);
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::shrinkToFit()
+{
+    std::size_t used{ chunkCount() };
+    while (m_chunk_count > used)
+    {
+        --m_chunk_count;
+        AllocTraits::deallocate(m_allocator, m_directory[m_chunk_count], ChunkSize);
+        m_directory[m_chunk_count] = nullptr;
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::clear()
+{
+    destroyRange(0, m_length);
+    m_length = 0;
+    shrinkToFit();
+    if (m_directory) { DirectoryTraits::deallocate(m_directory_allocator, m_directory, m_directory_capacity); }
+    m_directory = nullptr;
+    m_directory_capacity = 0;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::resize(std::size_t length)
+{
+    try
+    {
+        reserve(length);
+        while (m_length < length)
+        {
+            emplaceBack();
+        }
+        destroyRange(length, m_length);
+        m_length = length;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Standard exception caught: " << e.what() << "\n"
+                  << "Length of array remains " << size() << "\n";
+        return;
+    }
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::pushBack(const T& value)
+{
+    emplaceBack(value);
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::pushBack(T&& value)
+{
+    emplaceBack(std::move(value));
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+template <typename... Args>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::emplaceBack(Args&&... args)
+{
+    // Elements never move, so args may safely refer to an element of this array.
+    if (m_length == capacity())
+    {
+        allocateChunks(m_chunk_count + 1);
+    }
+    AllocTraits::construct(m_allocator, m_directory[m_length >> ChunkShift] + (m_length & ChunkMask), std::forward<Args>(args)...);
+    ++m_length;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::popBack()
+{
+    if (empty()) { return; }
+
+    --m_length;
+    AllocTraits::destroy(m_allocator, m_directory[m_length >> ChunkShift] + (m_length & ChunkMask));
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+int CustomSegmentedArray<T, ChunkShift, Allocator>::search(const T& value) const
+{
+    for (std::size_t index{ 0 }; index < chunkCount(); ++index)
+    {
+        CustomArrayView<const T> elements{ chunk(index) };
+        std::size_t position{ simdFind(elements.data(), elements.size(), value) };
+        if (position < elements.size())
+        {
+            return static_cast<int>((index << ChunkShift) + position);
+        }
+    }
+    return -1;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+std::size_t CustomSegmentedArray<T, ChunkShift, Allocator>::count(const T& value) const
+{
+    std::size_t total{ 0 };
+    for (std::size_t index{ 0 }; index < chunkCount(); ++index)
+    {
+        CustomArrayView<const T> elements{ chunk(index) };
+        total += simdCount(elements.data(), elements.size(), value);
+    }
+    return total;
+}
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+void CustomSegmentedArray<T, ChunkShift, Allocator>::swap(CustomSegmentedArray<T, ChunkShift, Allocator>& other)
+{
+    if (this == &other) { return; }
+
+    if (m_allocator == other.m_allocator)
+    {
+        std::swap(m_length, other.m_length);
+        std::swap(m_chunk_count, other.m_chunk_count);
+        std::swap(m_directory_capacity, other.m_directory_capacity);
+        std::swap(m_directory, other.m_directory);
+        return;
+    }
+
+    CustomSegmentedArray<T, ChunkShift, Allocator> temp{ std::move(other) };
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+// Public member functions definitions end here.
+
+// Friend function definitions begin here.
+
+template <typename T, std::size_t ChunkShift, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomSegmentedArray<T, ChunkShift, Allocator>& arr)
+{
+    return arr.display(out);
+}
+
+// Friend functions definitions end here.
+
+#endif // CUSTOMSEGMENTEDARRAY_H_INCLUDED
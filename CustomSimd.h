@@ -0,0 +1,1238 @@
+#ifndef CUSTOMSIMD_H_INCLUDED
+#define CUSTOMSIMD_H_INCLUDED
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint64_t
+#include <type_traits> // std::is_arithmetic
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUSTOMSIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(CUSTOMSIMD_SSE2) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CUSTOMSIMD_AVX2 1
+#include <immintrin.h>
+#define CUSTOMSIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+
+/*
+ *
+ * File:    CustomSimd.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains vectorised kernels used by the custom containers to scan arrays of elements,
+ *   and small bit manipulation, byte matching and prefetch helpers used by their search functions.
+ *   It also contains the block functions of the split block Bloom filter used by CustomBloomFilter.
+ *   Each kernel has overloads for int, float, double and char arrays that compare many elements per
+ *   instruction, and a function template for every other type that compares one element at a time.
+ *   The reduction kernels (sum, minimum and maximum, dot product) and fill have overloads for int, float
+ *   and double arrays. Sums of int arrays are accumulated in 64 bit integers, so they do not overflow.
+ *
+ *   On x86 processors, SSE2 kernels (16 bytes per instruction) are always available.
+ *   When compiled with GCC or Clang, AVX2 kernels (32 bytes per instruction) are also compiled, and are
+ *   selected at runtime if the processor supports them. Other processors use the one element at a time code.
+ *
+ */
+
+
+// Helper functions begin here.
+
+// Returns the index of the lowest set bit of a non-zero mask.
+inline unsigned simdLowestBit(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+    unsigned index{ 0 };
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Returns the index of the lowest set bit of a non-zero 64 bit mask.
+inline unsigned simdLowestBit64(std::uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#else
+    unsigned index{ 0 };
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Returns the index of the highest set bit of a non-zero 64 bit mask.
+inline unsigned simdHighestBit64(std::uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(mask));
+#else
+    unsigned index{ 0 };
+    while (mask >>= 1)
+    {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Returns the number of set bits in a mask.
+inline std::size_t simdPopCount(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcount(mask));
+#else
+    std::size_t count{ 0 };
+    for (; mask; mask &= mask - 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Returns true if the AVX2 kernels were compiled and the processor supports them. Checked once.
+inline bool simdHasAvx2()
+{
+#if defined(CUSTOMSIMD_AVX2)
+    static const bool supported{ __builtin_cpu_supports("avx2") != 0 };
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// Asks the processor to start loading the cache line holding address. Never faults, even for invalid addresses.
+inline void simdPrefetch(const void* address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(CUSTOMSIMD_SSE2)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+// Returns a mask with bit i set if group[i] is equal to byte, comparing the 16 bytes of group at once.
+inline unsigned simdMatchBytes16(const std::uint8_t* group, std::uint8_t byte)
+{
+#if defined(CUSTOMSIMD_SSE2)
+    __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(group)) };
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+    unsigned mask{ 0 };
+    for (unsigned index{ 0 }; index < 16; ++index)
+    {
+        mask |= static_cast<unsigned>(group[index] == byte) << index;
+    }
+    return mask;
+#endif
+}
+
+// Helper functions end here.
+
+
+// Lane operation definitions begin here.
+
+/*
+ *
+ *   Struct Names: SimdSse2Int, SimdSse2Float, SimdSse2Double, SimdSse2Char,
+ *                 SimdAvx2Int, SimdAvx2Float, SimdAvx2Double, SimdAvx2Char
+ *
+ *   Purpose:
+ *
+ *     Describe how one vector register of a given element type is loaded and compared.
+ *     Used as the Ops template parameter of the kernel engines.
+ *
+ *   Members:
+ *
+ *     Scalar
+ *       The element type.
+ *     Vector
+ *       The vector register type.
+ *     lanes
+ *       The number of elements in one vector register.
+ *     broadcast
+ *       Returns a vector with every lane equal to a value.
+ *     match
+ *       Compares a vector of elements from memory with a broadcast value.
+ *       Returns a mask with bit i set if element i is equal to the value.
+ *
+ *   The int, float and double structs also describe the arithmetic of the reduction kernels:
+ *
+ *     Sum, Wide
+ *       The type of a sum, and the vector register type that accumulates sums.
+ *     load, store
+ *       Load and store a vector of elements, at any alignment.
+ *     minimum, maximum
+ *       Return the lane-wise minimum or maximum of two vectors. If a lane of the first is NaN, the lane of
+ *       the second is returned, so NaNs read from memory are skipped.
+ *     zero, add
+ *       Return an accumulator of zeros, and the lane-wise sum of two accumulators.
+ *     accumulate, multiplyAccumulate
+ *       Add a vector of elements, or the products of two vectors of elements, from memory to an accumulator.
+ *     reduce
+ *       Returns the sum of the lanes of an accumulator.
+ *
+ */
+
+// The type returned by the sum and dot product kernels. Sums of int are accumulated in 64 bits.
+template <typename T>
+struct SimdSumType
+{
+    using type = T;
+};
+
+template <>
+struct SimdSumType<int>
+{
+    using type = long long;
+};
+
+#if defined(CUSTOMSIMD_SSE2)
+
+struct SimdSse2Int
+{
+    using Scalar = int;
+    using Vector = __m128i;
+    using Sum = long long;
+    using Wide = __m128i;
+    static constexpr std::size_t lanes{ 4 };
+    static Vector broadcast(Scalar value) { return _mm_set1_epi32(value); }
+    static unsigned match(const Scalar* data, Vector needle)
+    {
+        __m128i equal{ _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), needle) };
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+    }
+    static Vector load(const Scalar* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+    static void store(Scalar* data, Vector value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value); }
+
+    // SSE2 has no 32 bit minimum or maximum, so the lanes are selected with a comparison mask.
+    static Vector minimum(Vector a, Vector b)
+    {
+        __m128i less{ _mm_cmplt_epi32(a, b) };
+        return _mm_or_si128(_mm_and_si128(less, a), _mm_andnot_si128(less, b));
+    }
+    static Vector maximum(Vector a, Vector b)
+    {
+        __m128i greater{ _mm_cmpgt_epi32(a, b) };
+        return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+    }
+    static Wide zero() { return _mm_setzero_si128(); }
+    static Wide add(Wide a, Wide b) { return _mm_add_epi64(a, b); }
+
+    // Sign extends the four elements to 64 bits by interleaving them with their sign masks.
+    static Wide accumulate(Wide sum, const Scalar* data)
+    {
+        __m128i values{ load(data) };
+        __m128i signs{ _mm_srai_epi32(values, 31) };
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(values, signs));
+        return _mm_add_epi64(sum, _mm_unpackhi_epi32(values, signs));
+    }
+
+    // SSE2 has no signed 32 bit to 64 bit multiply, so the products are formed one at a time.
+    static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        return _mm_add_epi64(sum, _mm_set_epi64x(static_cast<long long>(a[1]) * b[1] + static_cast<long long>(a[3]) * b[3],
+                                                 static_cast<long long>(a[0]) * b[0] + static_cast<long long>(a[2]) * b[2]));
+    }
+    static Sum reduce(Wide sum)
+    {
+        long long lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+        return lanes[0] + lanes[1];
+    }
+};
+
+struct SimdSse2Float
+{
+    using Scalar = float;
+    using Vector = __m128;
+    using Sum = float;
+    using Wide = __m128;
+    static constexpr std::size_t lanes{ 4 };
+    static Vector broadcast(Scalar value) { return _mm_set1_ps(value); }
+    static unsigned match(const Scalar* data, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data), needle)));
+    }
+    static Vector load(const Scalar* data) { return _mm_loadu_ps(data); }
+    static void store(Scalar* data, Vector value) { _mm_storeu_ps(data, value); }
+    static Vector minimum(Vector a, Vector b) { return _mm_min_ps(a, b); }
+    static Vector maximum(Vector a, Vector b) { return _mm_max_ps(a, b); }
+    static Wide zero() { return _mm_setzero_ps(); }
+    static Wide add(Wide a, Wide b) { return _mm_add_ps(a, b); }
+    static Wide accumulate(Wide sum, const Scalar* data) { return _mm_add_ps(sum, _mm_loadu_ps(data)); }
+    static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        return _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+    }
+    static Sum reduce(Wide sum)
+    {
+        float lanes[4];
+        _mm_storeu_ps(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct SimdSse2Double
+{
+    using Scalar = double;
+    using Vector = __m128d;
+    using Sum = double;
+    using Wide = __m128d;
+    static constexpr std::size_t lanes{ 2 };
+    static Vector broadcast(Scalar value) { return _mm_set1_pd(value); }
+    static unsigned match(const Scalar* data, Vector needle)
+    {
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data), needle)));
+    }
+    static Vector load(const Scalar* data) { return _mm_loadu_pd(data); }
+    static void store(Scalar* data, Vector value) { _mm_storeu_pd(data, value); }
+    static Vector minimum(Vector a, Vector b) { return _mm_min_pd(a, b); }
+    static Vector maximum(Vector a, Vector b) { return _mm_max_pd(a, b); }
+    static Wide zero() { return _mm_setzero_pd(); }
+    static Wide add(Wide a, Wide b) { return _mm_add_pd(a, b); }
+    static Wide accumulate(Wide sum, const Scalar* data) { return _mm_add_pd(sum, _mm_loadu_pd(data)); }
+    static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        return _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    }
+    static Sum reduce(Wide sum)
+    {
+        double lanes[2];
+        _mm_storeu_pd(lanes, sum);
+        return lanes[0] + lanes[1];
+    }
+};
+
+struct SimdSse2Char
+{
+    using Scalar = char;
+    using Vector = __m128i;
+    static constexpr std::size_t lanes{ 16 };
+    static Vector broadcast(Scalar value) { return _mm_set1_epi8(value); }
+    static unsigned match(const Scalar* data, Vector needle)
+    {
+        __m128i equal{ _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), needle) };
+        return static_cast<unsigned>(_mm_movemask_epi8(equal));
+    }
+};
+
+#endif // CUSTOMSIMD_SSE2
+
+#if defined(CUSTOMSIMD_AVX2)
+
+struct SimdAvx2Int
+{
+    using Scalar = int;
+    using Vector = __m256i;
+    using Sum = long long;
+    using Wide = __m256i;
+    static constexpr std::size_t lanes{ 8 };
+    CUSTOMSIMD_TARGET_AVX2 static Vector broadcast(Scalar value) { return _mm256_set1_epi32(value); }
+    CUSTOMSIMD_TARGET_AVX2 static unsigned match(const Scalar* data, Vector needle)
+    {
+        __m256i equal{ _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), needle) };
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(equal)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Vector load(const Scalar* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+    CUSTOMSIMD_TARGET_AVX2 static void store(Scalar* data, Vector value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector minimum(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector maximum(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide zero() { return _mm256_setzero_si256(); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide add(Wide a, Wide b) { return _mm256_add_epi64(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide accumulate(Wide sum, const Scalar* data)
+    {
+        __m256i values{ load(data) };
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        return _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+
+    // _mm256_mul_epi32 multiplies the even lanes to 64 bits, so the odd lanes are shifted down to multiply them.
+    CUSTOMSIMD_TARGET_AVX2 static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        __m256i x{ load(a) };
+        __m256i y{ load(b) };
+        sum = _mm256_add_epi64(sum, _mm256_mul_epi32(x, y));
+        return _mm256_add_epi64(sum, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Sum reduce(Wide sum)
+    {
+        long long lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct SimdAvx2Float
+{
+    using Scalar = float;
+    using Vector = __m256;
+    using Sum = float;
+    using Wide = __m256;
+    static constexpr std::size_t lanes{ 8 };
+    CUSTOMSIMD_TARGET_AVX2 static Vector broadcast(Scalar value) { return _mm256_set1_ps(value); }
+    CUSTOMSIMD_TARGET_AVX2 static unsigned match(const Scalar* data, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data), needle, _CMP_EQ_OQ)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Vector load(const Scalar* data) { return _mm256_loadu_ps(data); }
+    CUSTOMSIMD_TARGET_AVX2 static void store(Scalar* data, Vector value) { _mm256_storeu_ps(data, value); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector minimum(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector maximum(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide zero() { return _mm256_setzero_ps(); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide add(Wide a, Wide b) { return _mm256_add_ps(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide accumulate(Wide sum, const Scalar* data) { return _mm256_add_ps(sum, _mm256_loadu_ps(data)); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        return _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Sum reduce(Wide sum)
+    {
+        float lanes[8];
+        _mm256_storeu_ps(lanes, sum);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+};
+
+struct SimdAvx2Double
+{
+    using Scalar = double;
+    using Vector = __m256d;
+    using Sum = double;
+    using Wide = __m256d;
+    static constexpr std::size_t lanes{ 4 };
+    CUSTOMSIMD_TARGET_AVX2 static Vector broadcast(Scalar value) { return _mm256_set1_pd(value); }
+    CUSTOMSIMD_TARGET_AVX2 static unsigned match(const Scalar* data, Vector needle)
+    {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data), needle, _CMP_EQ_OQ)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Vector load(const Scalar* data) { return _mm256_loadu_pd(data); }
+    CUSTOMSIMD_TARGET_AVX2 static void store(Scalar* data, Vector value) { _mm256_storeu_pd(data, value); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector minimum(Vector a, Vector b) { return _mm256_min_pd(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Vector maximum(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide zero() { return _mm256_setzero_pd(); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide add(Wide a, Wide b) { return _mm256_add_pd(a, b); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide accumulate(Wide sum, const Scalar* data) { return _mm256_add_pd(sum, _mm256_loadu_pd(data)); }
+    CUSTOMSIMD_TARGET_AVX2 static Wide multiplyAccumulate(Wide sum, const Scalar* a, const Scalar* b)
+    {
+        return _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+    CUSTOMSIMD_TARGET_AVX2 static Sum reduce(Wide sum)
+    {
+        double lanes[4];
+        _mm256_storeu_pd(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct SimdAvx2Char
+{
+    using Scalar = char;
+    using Vector = __m256i;
+    static constexpr std::size_t lanes{ 32 };
+    CUSTOMSIMD_TARGET_AVX2 static Vector broadcast(Scalar value) { return _mm256_set1_epi8(value); }
+    CUSTOMSIMD_TARGET_AVX2 static unsigned match(const Scalar* data, Vector needle)
+    {
+        __m256i equal{ _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), needle) };
+        return static_cast<unsigned>(_mm256_movemask_epi8(equal));
+    }
+};
+
+#endif // CUSTOMSIMD_AVX2
+
+// Lane operation definitions end here.
+
+
+// Kernel engine definitions begin here.
+
+/*
+ *
+ * template <typename Ops>
+ * std::size_t simdFindKernel(const typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value);
+ *
+ * Summary:
+ *
+ *   Returns the index of the first element equal to value, or length if there is none.
+ *
+ * Description:
+ *
+ *   Compares Ops::lanes elements per iteration, stopping at the first vector with a match.
+ *   The remaining elements are compared one at a time.
+ *   The AVX2 engine is a copy compiled for AVX2, so that the Ops functions can be inlined into it.
+ *
+ */
+#if defined(CUSTOMSIMD_SSE2)
+
+template <typename Ops>
+std::size_t simdFindKernel(const typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value)
+{
+    typename Ops::Vector needle{ Ops::broadcast(value) };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        unsigned mask{ Ops::match(data + index, needle) };
+        if (mask) { return index + simdLowestBit(mask); }
+    }
+    for (; index < length; ++index)
+    {
+        if (data[index] == value) { return index; }
+    }
+    return length;
+}
+
+template <typename Ops>
+std::size_t simdCountKernel(const typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value)
+{
+    typename Ops::Vector needle{ Ops::broadcast(value) };
+    std::size_t count{ 0 };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        count += simdPopCount(Ops::match(data + index, needle));
+    }
+    for (; index < length; ++index)
+    {
+        count += (data[index] == value);
+    }
+    return count;
+}
+
+#endif // CUSTOMSIMD_SSE2
+
+#if defined(CUSTOMSIMD_AVX2)
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 std::size_t simdFindKernelAvx2(const typename Ops::Scalar* data, std::size_t length,
+                                                      typename Ops::Scalar value)
+{
+    typename Ops::Vector needle{ Ops::broadcast(value) };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        unsigned mask{ Ops::match(data + index, needle) };
+        if (mask) { return index + simdLowestBit(mask); }
+    }
+    for (; index < length; ++index)
+    {
+        if (data[index] == value) { return index; }
+    }
+    return length;
+}
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 std::size_t simdCountKernelAvx2(const typename Ops::Scalar* data, std::size_t length,
+                                                       typename Ops::Scalar value)
+{
+    typename Ops::Vector needle{ Ops::broadcast(value) };
+    std::size_t count{ 0 };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        count += simdPopCount(Ops::match(data + index, needle));
+    }
+    for (; index < length; ++index)
+    {
+        count += (data[index] == value);
+    }
+    return count;
+}
+
+
+#endif // CUSTOMSIMD_AVX2
+
+#if defined(CUSTOMSIMD_SSE2)
+
+/*
+ *
+ * template <typename Ops>
+ * typename Ops::Sum simdSumKernel(const typename Ops::Scalar* data, std::size_t length);
+ * template <typename Ops>
+ * typename Ops::Sum simdDotKernel(const typename Ops::Scalar* a, const typename Ops::Scalar* b, std::size_t length);
+ * template <typename Ops>
+ * void simdMinMaxKernel(const typename Ops::Scalar* data, std::size_t length,
+ *                       typename Ops::Scalar& low, typename Ops::Scalar& high);
+ * template <typename Ops>
+ * void simdFillKernel(typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value);
+ *
+ * Summary:
+ *
+ *   Return the sum of the elements, or of the products of two arrays of elements, find the least and greatest
+ *   elements, or set every element to a value.
+ *
+ * Description:
+ *
+ *   The sum and dot product keep four independent accumulators, so that consecutive additions do not wait
+ *   for each other, and combine them at the end. Floating point sums are therefore added in a different order
+ *   than a loop would add them, and may differ from it in the last bits.
+ *   The minimum and maximum kernel requires length to be at least one.
+ *   The remaining elements after the last full vector are handled one at a time.
+ *
+ */
+template <typename Ops>
+typename Ops::Sum simdSumKernel(const typename Ops::Scalar* data, std::size_t length)
+{
+    typename Ops::Wide sums[4]{ Ops::zero(), Ops::zero(), Ops::zero(), Ops::zero() };
+    std::size_t index{ 0 };
+    for (; index + 4 * Ops::lanes <= length; index += 4 * Ops::lanes)
+    {
+        sums[0] = Ops::accumulate(sums[0], data + index);
+        sums[1] = Ops::accumulate(sums[1], data + index + Ops::lanes);
+        sums[2] = Ops::accumulate(sums[2], data + index + 2 * Ops::lanes);
+        sums[3] = Ops::accumulate(sums[3], data + index + 3 * Ops::lanes);
+    }
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        sums[0] = Ops::accumulate(sums[0], data + index);
+    }
+    typename Ops::Sum sum{ Ops::reduce(Ops::add(Ops::add(sums[0], sums[1]), Ops::add(sums[2], sums[3]))) };
+    for (; index < length; ++index)
+    {
+        sum += data[index];
+    }
+    return sum;
+}
+
+template <typename Ops>
+typename Ops::Sum simdDotKernel(const typename Ops::Scalar* a, const typename Ops::Scalar* b, std::size_t length)
+{
+    typename Ops::Wide sums[4]{ Ops::zero(), Ops::zero(), Ops::zero(), Ops::zero() };
+    std::size_t index{ 0 };
+    for (; index + 4 * Ops::lanes <= length; index += 4 * Ops::lanes)
+    {
+        sums[0] = Ops::multiplyAccumulate(sums[0], a + index, b + index);
+        sums[1] = Ops::multiplyAccumulate(sums[1], a + index + Ops::lanes, b + index + Ops::lanes);
+        sums[2] = Ops::multiplyAccumulate(sums[2], a + index + 2 * Ops::lanes, b + index + 2 * Ops::lanes);
+        sums[3] = Ops::multiplyAccumulate(sums[3], a + index + 3 * Ops::lanes, b + index + 3 * Ops::lanes);
+    }
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        sums[0] = Ops::multiplyAccumulate(sums[0], a + index, b + index);
+    }
+    typename Ops::Sum sum{ Ops::reduce(Ops::add(Ops::add(sums[0], sums[1]), Ops::add(sums[2], sums[3]))) };
+    for (; index < length; ++index)
+    {
+        sum += static_cast<typename Ops::Sum>(a[index]) * b[index];
+    }
+    return sum;
+}
+
+template <typename Ops>
+void simdMinMaxKernel(const typename Ops::Scalar* data, std::size_t length,
+                      typename Ops::Scalar& low, typename Ops::Scalar& high)
+{
+    low = data[0];
+    high = data[0];
+    std::size_t index{ 0 };
+    if (length >= Ops::lanes)
+    {
+        typename Ops::Vector lows{ Ops::load(data) };
+        typename Ops::Vector highs{ lows };
+        for (index = Ops::lanes; index + Ops::lanes <= length; index += Ops::lanes)
+        {
+            typename Ops::Vector values{ Ops::load(data + index) };
+            lows = Ops::minimum(values, lows);
+            highs = Ops::maximum(values, highs);
+        }
+        typename Ops::Scalar lowLanes[Ops::lanes];
+        typename Ops::Scalar highLanes[Ops::lanes];
+        Ops::store(lowLanes, lows);
+        Ops::store(highLanes, highs);
+        for (std::size_t lane{ 0 }; lane < Ops::lanes; ++lane)
+        {
+            if (lowLanes[lane] < low) { low = lowLanes[lane]; }
+            if (high < highLanes[lane]) { high = highLanes[lane]; }
+        }
+    }
+    for (; index < length; ++index)
+    {
+        if (data[index] < low) { low = data[index]; }
+        if (high < data[index]) { high = data[index]; }
+    }
+}
+
+template <typename Ops>
+void simdFillKernel(typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value)
+{
+    typename Ops::Vector values{ Ops::broadcast(value) };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        Ops::store(data + index, values);
+    }
+    for (; index < length; ++index)
+    {
+        data[index] = value;
+    }
+}
+
+#endif // CUSTOMSIMD_SSE2
+
+#if defined(CUSTOMSIMD_AVX2)
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 typename Ops::Sum simdSumKernelAvx2(const typename Ops::Scalar* data, std::size_t length)
+{
+    typename Ops::Wide sums[4]{ Ops::zero(), Ops::zero(), Ops::zero(), Ops::zero() };
+    std::size_t index{ 0 };
+    for (; index + 4 * Ops::lanes <= length; index += 4 * Ops::lanes)
+    {
+        sums[0] = Ops::accumulate(sums[0], data + index);
+        sums[1] = Ops::accumulate(sums[1], data + index + Ops::lanes);
+        sums[2] = Ops::accumulate(sums[2], data + index + 2 * Ops::lanes);
+        sums[3] = Ops::accumulate(sums[3], data + index + 3 * Ops::lanes);
+    }
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        sums[0] = Ops::accumulate(sums[0], data + index);
+    }
+    typename Ops::Sum sum{ Ops::reduce(Ops::add(Ops::add(sums[0], sums[1]), Ops::add(sums[2], sums[3]))) };
+    for (; index < length; ++index)
+    {
+        sum += data[index];
+    }
+    return sum;
+}
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 typename Ops::Sum simdDotKernelAvx2(const typename Ops::Scalar* a, const typename Ops::Scalar* b, std::size_t length)
+{
+    typename Ops::Wide sums[4]{ Ops::zero(), Ops::zero(), Ops::zero(), Ops::zero() };
+    std::size_t index{ 0 };
+    for (; index + 4 * Ops::lanes <= length; index += 4 * Ops::lanes)
+    {
+        sums[0] = Ops::multiplyAccumulate(sums[0], a + index, b + index);
+        sums[1] = Ops::multiplyAccumulate(sums[1], a + index + Ops::lanes, b + index + Ops::lanes);
+        sums[2] = Ops::multiplyAccumulate(sums[2], a + index + 2 * Ops::lanes, b + index + 2 * Ops::lanes);
+        sums[3] = Ops::multiplyAccumulate(sums[3], a + index + 3 * Ops::lanes, b + index + 3 * Ops::lanes);
+    }
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        sums[0] = Ops::multiplyAccumulate(sums[0], a + index, b + index);
+    }
+    typename Ops::Sum sum{ Ops::reduce(Ops::add(Ops::add(sums[0], sums[1]), Ops::add(sums[2], sums[3]))) };
+    for (; index < length; ++index)
+    {
+        sum += static_cast<typename Ops::Sum>(a[index]) * b[index];
+    }
+    return sum;
+}
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 void simdMinMaxKernelAvx2(const typename Ops::Scalar* data, std::size_t length,
+                                                 typename Ops::Scalar& low, typename Ops::Scalar& high)
+{
+    low = data[0];
+    high = data[0];
+    std::size_t index{ 0 };
+    if (length >= Ops::lanes)
+    {
+        typename Ops::Vector lows{ Ops::load(data) };
+        typename Ops::Vector highs{ lows };
+        for (index = Ops::lanes; index + Ops::lanes <= length; index += Ops::lanes)
+        {
+            typename Ops::Vector values{ Ops::load(data + index) };
+            lows = Ops::minimum(values, lows);
+            highs = Ops::maximum(values, highs);
+        }
+        typename Ops::Scalar lowLanes[Ops::lanes];
+        typename Ops::Scalar highLanes[Ops::lanes];
+        Ops::store(lowLanes, lows);
+        Ops::store(highLanes, highs);
+        for (std::size_t lane{ 0 }; lane < Ops::lanes; ++lane)
+        {
+            if (lowLanes[lane] < low) { low = lowLanes[lane]; }
+            if (high < highLanes[lane]) { high = highLanes[lane]; }
+        }
+    }
+    for (; index < length; ++index)
+    {
+        if (data[index] < low) { low = data[index]; }
+        if (high < data[index]) { high = data[index]; }
+    }
+}
+
+template <typename Ops>
+CUSTOMSIMD_TARGET_AVX2 void simdFillKernelAvx2(typename Ops::Scalar* data, std::size_t length, typename Ops::Scalar value)
+{
+    typename Ops::Vector values{ Ops::broadcast(value) };
+    std::size_t index{ 0 };
+    for (; index + Ops::lanes <= length; index += Ops::lanes)
+    {
+        Ops::store(data + index, values);
+    }
+    for (; index < length; ++index)
+    {
+        data[index] = value;
+    }
+}
+
+// A copy of the transform loop compiled for AVX2, so that the compiler can vectorise it with 32 byte registers.
+template <typename T, typename Function>
+CUSTOMSIMD_TARGET_AVX2 void simdTransformKernelAvx2(T* data, std::size_t length, Function function)
+{
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        data[index] = function(data[index]);
+    }
+}
+
+
+#endif // CUSTOMSIMD_AVX2
+
+// Kernel engine definitions end here.
+
+
+// Kernel function definitions begin here.
+
+/*
+ *
+ * template <typename T>
+ * std::size_t simdFind(const T* data, std::size_t length, const T& value);
+ *
+ * Summary:
+ *
+ *   Returns the index of the first element equal to value, or length if there is none.
+ *
+ * Description:
+ *
+ *   Compares the elements [data, data + length) with value using operator ==, one at a time.
+ *   The overloads for int, float, double and char arrays use the AVX2 or SSE2 kernels where available.
+ *
+ */
+template <typename T>
+std::size_t simdFind(const T* data, std::size_t length, const T& value)
+{
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        if (data[index] == value) { return index; }
+    }
+    return length;
+}
+
+/*
+ *
+ * template <typename T>
+ * std::size_t simdCount(const T* data, std::size_t length, const T& value);
+ *
+ * Summary:
+ *
+ *   Returns the number of elements equal to value.
+ *
+ * Description:
+ *
+ *   Compares the elements [data, data + length) with value using operator ==, one at a time.
+ *   The overloads for int, float, double and char arrays use the AVX2 or SSE2 kernels where available.
+ *
+ */
+template <typename T>
+std::size_t simdCount(const T* data, std::size_t length, const T& value)
+{
+    std::size_t count{ 0 };
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        count += (data[index] == value);
+    }
+    return count;
+}
+
+/*
+ *
+ * template <typename T>
+ * typename SimdSumType<T>::type simdSum(const T* data, std::size_t length);
+ *
+ * Summary:
+ *
+ *   Returns the sum of the elements, or zero if there are none.
+ *
+ * Description:
+ *
+ *   Adds the elements [data, data + length) using operator +=, one at a time.
+ *   The overloads for int, float and double arrays use the AVX2 or SSE2 kernels where available.
+ *
+ */
+template <typename T>
+typename SimdSumType<T>::type simdSum(const T* data, std::size_t length)
+{
+    typename SimdSumType<T>::type sum{};
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        sum += data[index];
+    }
+    return sum;
+}
+
+/*
+ *
+ * template <typename T>
+ * typename SimdSumType<T>::type simdDot(const T* a, const T* b, std::size_t length);
+ *
+ * Summary:
+ *
+ *   Returns the sum of the products of the elements of two arrays (their dot product), or zero if length is zero.
+ *
+ * Description:
+ *
+ *   Multiplies a[i] by b[i] for each i in [0, length), and adds the products, one at a time.
+ *   The overloads for int, float and double arrays use the AVX2 or SSE2 kernels where available.
+ *
+ */
+template <typename T>
+typename SimdSumType<T>::type simdDot(const T* a, const T* b, std::size_t length)
+{
+    typename SimdSumType<T>::type sum{};
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        sum += static_cast<typename SimdSumType<T>::type>(a[index]) * b[index];
+    }
+    return sum;
+}
+
+/*
+ *
+ * template <typename T>
+ * void simdMinMax(const T* data, std::size_t length, T& low, T& high);
+ *
+ * Summary:
+ *
+ *   Finds the least and greatest elements.
+ *
+ * Description:
+ *
+ *   Sets low to the first element that no other element is less than, and high to the first element that
+ *   is not less than any other element, comparing with operator <. length must be at least one.
+ *   NaNs are skipped unless the first element is NaN.
+ *   The overloads for int, float and double arrays use the AVX2 or SSE2 kernels where available.
+ *
+ */
+template <typename T>
+void simdMinMax(const T* data, std::size_t length, T& low, T& high)
+{
+    low = data[0];
+    high = data[0];
+    for (std::size_t index{ 1 }; index < length; ++index)
+    {
+        if (data[index] < low) { low = data[index]; }
+        if (high < data[index]) { high = data[index]; }
+    }
+}
+
+/*
+ *
+ * template <typename T>
+ * void simdFill(T* data, std::size_t length, const T& value);
+ *
+ * Summary:
+ *
+ *   Assigns value to every element.
+ *
+ * Description:
+ *
+ *   Assigns value to the elements [data, data + length) one at a time.
+ *   The overloads for int, float and double arrays store whole vectors using the AVX2 or SSE2 kernels.
+ *
+ */
+template <typename T>
+void simdFill(T* data, std::size_t length, const T& value)
+{
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        data[index] = value;
+    }
+}
+
+/*
+ *
+ * template <typename T, typename Function>
+ * void simdTransform(T* data, std::size_t length, Function function);
+ *
+ * Summary:
+ *
+ *   Replaces every element x with function(x).
+ *
+ * Description:
+ *
+ *   function is an arbitrary callable, so there is no hand written kernel. Instead, for arithmetic element
+ *   types on processors with AVX2, the loop runs in a copy compiled for AVX2, which the compiler can
+ *   vectorise when function is simple arithmetic. Otherwise the loop is compiled for the default target.
+ *
+ */
+template <typename T, typename Function>
+void simdTransform(T* data, std::size_t length, Function function)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (std::is_arithmetic<T>::value && simdHasAvx2())
+    {
+        simdTransformKernelAvx2(data, length, function);
+        return;
+    }
+#endif
+    for (std::size_t index{ 0 }; index < length; ++index)
+    {
+        data[index] = function(data[index]);
+    }
+}
+
+#if defined(CUSTOMSIMD_SSE2)
+
+inline std::size_t simdFind(const int* data, std::size_t length, const int& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdFindKernelAvx2<SimdAvx2Int>(data, length, value); }
+#endif
+    return simdFindKernel<SimdSse2Int>(data, length, value);
+}
+
+inline std::size_t simdFind(const float* data, std::size_t length, const float& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdFindKernelAvx2<SimdAvx2Float>(data, length, value); }
+#endif
+    return simdFindKernel<SimdSse2Float>(data, length, value);
+}
+
+inline std::size_t simdFind(const double* data, std::size_t length, const double& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdFindKernelAvx2<SimdAvx2Double>(data, length, value); }
+#endif
+    return simdFindKernel<SimdSse2Double>(data, length, value);
+}
+
+inline std::size_t simdFind(const char* data, std::size_t length, const char& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdFindKernelAvx2<SimdAvx2Char>(data, length, value); }
+#endif
+    return simdFindKernel<SimdSse2Char>(data, length, value);
+}
+
+inline std::size_t simdCount(const int* data, std::size_t length, const int& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdCountKernelAvx2<SimdAvx2Int>(data, length, value); }
+#endif
+    return simdCountKernel<SimdSse2Int>(data, length, value);
+}
+
+inline std::size_t simdCount(const float* data, std::size_t length, const float& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdCountKernelAvx2<SimdAvx2Float>(data, length, value); }
+#endif
+    return simdCountKernel<SimdSse2Float>(data, length, value);
+}
+
+inline std::size_t simdCount(const double* data, std::size_t length, const double& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdCountKernelAvx2<SimdAvx2Double>(data, length, value); }
+#endif
+    return simdCountKernel<SimdSse2Double>(data, length, value);
+}
+
+inline std::size_t simdCount(const char* data, std::size_t length, const char& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdCountKernelAvx2<SimdAvx2Char>(data, length, value); }
+#endif
+    return simdCountKernel<SimdSse2Char>(data, length, value);
+}
+
+inline long long simdSum(const int* data, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdSumKernelAvx2<SimdAvx2Int>(data, length); }
+#endif
+    return simdSumKernel<SimdSse2Int>(data, length);
+}
+
+inline float simdSum(const float* data, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdSumKernelAvx2<SimdAvx2Float>(data, length); }
+#endif
+    return simdSumKernel<SimdSse2Float>(data, length);
+}
+
+inline double simdSum(const double* data, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdSumKernelAvx2<SimdAvx2Double>(data, length); }
+#endif
+    return simdSumKernel<SimdSse2Double>(data, length);
+}
+
+inline long long simdDot(const int* a, const int* b, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdDotKernelAvx2<SimdAvx2Int>(a, b, length); }
+#endif
+    return simdDotKernel<SimdSse2Int>(a, b, length);
+}
+
+inline float simdDot(const float* a, const float* b, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdDotKernelAvx2<SimdAvx2Float>(a, b, length); }
+#endif
+    return simdDotKernel<SimdSse2Float>(a, b, length);
+}
+
+inline double simdDot(const double* a, const double* b, std::size_t length)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdDotKernelAvx2<SimdAvx2Double>(a, b, length); }
+#endif
+    return simdDotKernel<SimdSse2Double>(a, b, length);
+}
+
+inline void simdMinMax(const int* data, std::size_t length, int& low, int& high)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdMinMaxKernelAvx2<SimdAvx2Int>(data, length, low, high); return; }
+#endif
+    simdMinMaxKernel<SimdSse2Int>(data, length, low, high);
+}
+
+inline void simdMinMax(const float* data, std::size_t length, float& low, float& high)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdMinMaxKernelAvx2<SimdAvx2Float>(data, length, low, high); return; }
+#endif
+    simdMinMaxKernel<SimdSse2Float>(data, length, low, high);
+}
+
+inline void simdMinMax(const double* data, std::size_t length, double& low, double& high)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdMinMaxKernelAvx2<SimdAvx2Double>(data, length, low, high); return; }
+#endif
+    simdMinMaxKernel<SimdSse2Double>(data, length, low, high);
+}
+
+inline void simdFill(int* data, std::size_t length, const int& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdFillKernelAvx2<SimdAvx2Int>(data, length, value); return; }
+#endif
+    simdFillKernel<SimdSse2Int>(data, length, value);
+}
+
+inline void simdFill(float* data, std::size_t length, const float& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdFillKernelAvx2<SimdAvx2Float>(data, length, value); return; }
+#endif
+    simdFillKernel<SimdSse2Float>(data, length, value);
+}
+
+inline void simdFill(double* data, std::size_t length, const double& value)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdFillKernelAvx2<SimdAvx2Double>(data, length, value); return; }
+#endif
+    simdFillKernel<SimdSse2Double>(data, length, value);
+}
+
+#endif // CUSTOMSIMD_SSE2
+
+// Kernel function definitions end here.
+
+// Bloom filter block function definitions begin here.
+
+/*
+ *
+ * void simdBloomInsert(std::uint32_t* block, std::uint32_t key);
+ * bool simdBloomCheck(const std::uint32_t* block, std::uint32_t key);
+ *
+ * Summary:
+ *
+ *   Set, or test, the bits of a key in one 256 bit block of a split block Bloom filter.
+ *
+ * Description:
+ *
+ *   A block is eight 32 bit words, aligned to 32 bytes. A key sets one bit in each word: the bit given by
+ *   the top 5 bits of key multiplied by the salt of that word. simdBloomCheck returns true if all eight bits
+ *   are set. All eight words of the block are in one cache line, so a check reads one cache line.
+ *   The AVX2 functions compute and test all eight bits with a few instructions, and are selected at runtime
+ *   if the processor supports them. Else, the words are handled one at a time.
+ *
+ */
+
+// Returns the eight salts, one per word of a block. The array is local to an inline function, so every
+// translation unit shares the same one.
+inline const std::uint32_t* simdBloomSalts()
+{
+    static constexpr std::uint32_t salts[8]{ 0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                                             0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+    return salts;
+}
+
+#if defined(CUSTOMSIMD_AVX2)
+
+// Returns the eight words of the bits of key, one bit per word.
+CUSTOMSIMD_TARGET_AVX2 inline __m256i simdBloomMaskAvx2(std::uint32_t key)
+{
+    __m256i salts{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(simdBloomSalts())) };
+    __m256i shifts{ _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27) };
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+}
+
+CUSTOMSIMD_TARGET_AVX2 inline void simdBloomInsertAvx2(std::uint32_t* block, std::uint32_t key)
+{
+    __m256i* words{ reinterpret_cast<__m256i*>(block) };
+    _mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words), simdBloomMaskAvx2(key)));
+}
+
+CUSTOMSIMD_TARGET_AVX2 inline bool simdBloomCheckAvx2(const std::uint32_t* block, std::uint32_t key)
+{
+    // testc is 1 if every bit set in the mask is also set in the block.
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)), simdBloomMaskAvx2(key)) != 0;
+}
+
+#endif // CUSTOMSIMD_AVX2
+
+inline void simdBloomInsert(std::uint32_t* block, std::uint32_t key)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { simdBloomInsertAvx2(block, key); return; }
+#endif
+    for (std::size_t word{ 0 }; word < 8; ++word)
+    {
+        block[word] |= 1u << ((key * simdBloomSalts()[word]) >> 27);
+    }
+}
+
+inline bool simdBloomCheck(const std::uint32_t* block, std::uint32_t key)
+{
+#if defined(CUSTOMSIMD_AVX2)
+    if (simdHasAvx2()) { return simdBloomCheckAvx2(block, key); }
+#endif
+    std::uint32_t missing{ 0 };
+    for (std::size_t word{ 0 }; word < 8; ++word)
+    {
+        missing |= (1u << ((key * simdBloomSalts()[word]) >> 27)) & ~block[word];
+    }
+    return missing == 0;
+}
+
+// Bloom filter block function definitions end here.
+
+#endif // CUSTOMSIMD_H_INCLUDED
@@ -0,0 +1,1040 @@
+#ifndef CUSTOMSMALLARRAY_H_INCLUDED
+#define CUSTOMSMALLARRAY_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t
+#include <utility>     // std::swap, std::move, std::forward, std::initializer_list
+#include <memory>      // std::allocator, std::allocator_traits
+#include <type_traits> // std::is_trivially_copyable, std::is_trivially_destructible
+#include <cstring>     // std::memcpy
+#include "CustomArray.h"
+#include "CustomSimd.h"
+
+
+/*
+ *
+ * File:    CustomSmallArray.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a custom array container with a small buffer optimisation, in the form of a
+ *   class template CustomSmallArray.
+ *   The first N elements are stored inside the array object itself, so an array that never holds more than
+ *   N elements never allocates heap memory. Beyond N elements, the array moves its elements to heap memory
+ *   obtained from an Allocator, and grows geometrically from there like CustomArray.
+ *
+ *   The element access, insertion, erasure, sort, search and count members have the same names and meaning
+ *   as those of CustomArray, and the iterators are CustomArray's own, so code using only these works with
+ *   either array. The rest of CustomArray, such as range insertion, eraseIf, findAll, radixSort, parallelSort
+ *   and the numeric and set operations, is not provided. A CustomArrayView of the array offers sum, minMax,
+ *   transform and the set operations without copying.
+ *   Sorting uses the CustomArray sort engine.
+ *
+ *   The template class has been tested with the following data types:
+ *     * Integers
+ *     * Floats
+ *     * Doubles
+ *     * Characters
+ *     * C++ strings (std::string)
+ *
+ */
+
+
+// Forward declarations of class template CustomSmallArray and associated friend functions begin here.
+// Required to support class template functionality.
+
+
+/*
+ *
+ *   Class Name: CustomSmallArray
+ *
+ *   Purpose:
+ *
+ *     A custom array container class template that stores up to N elements without allocating memory.
+ *
+ *   Member Variables:
+ *
+ *     m_length
+ *       An unsigned integer (std::size_t) that tracks the number of elements in the array.
+ *     m_capacity
+ *       An unsigned integer (std::size_t) that tracks the number of elements the current memory can hold.
+ *     m_array_ptr
+ *       A pointer to the first element, either in m_inline or in heap memory. Only the first m_length elements
+ *       are constructed.
+ *     m_inline
+ *       Uninitialised memory inside the array object for N elements.
+ *     m_allocator
+ *       An Allocator object that allocates and deallocates heap memory once the array holds more than N elements.
+ *
+ *   Member Functions:
+ *
+ *     inlineData
+ *       Returns a pointer to the first element of m_inline.
+ *     isInline
+ *       Checks if the elements are stored in m_inline.
+ *     constructMoves
+ *       Move-constructs elements in uninitialised memory.
+ *     destroyRange
+ *       Destroys elements, leaving uninitialised memory.
+ *     reallocate
+ *       Moves the array data into memory of the specified capacity.
+ *     display
+ *       Prints the array data to the specified output stream.
+ *     size
+ *       Returns m_length
+ *     empty
+ *       Returns a bool False if m_length is zero. Else, returns True.
+ *     capacity
+ *       Returns m_capacity
+ *     data
+ *       Returns a pointer to the first element.
+ *     isSmall
+ *       Returns a bool True if the elements are stored inside the array object.
+ *     reserve
+ *       Allocates memory for at least the specified number of elements.
+ *     shrinkToFit
+ *       Releases any heap memory that is not used by the array elements.
+ *     clear
+ *       Removes the array data from memory and the array.
+ *     resize
+ *       Resize function. All elements are kept in the array up to the new length.
+ *     insert
+ *       Inserts data into the array at the specified position.
+ *     emplace
+ *       Constructs a new element in place at the specified position.
+ *     erase
+ *       Removes data from the array at the specified position.
+ *     pushBack
+ *       Appends a new value to the end of the array.
+ *     emplaceBack
+ *       Constructs a new element in place at the end of the array.
+ *     pushFront
+ *       Inserts a new value at the start of the array.
+ *     popBack
+ *       Removes an existing value from the end of the array.
+ *     popFront
+ *       Removes an existing value from the start of the array.
+ *     reverse
+ *       Reverses the order of the array elements in place.
+ *     sort
+ *       Sorts the array in ascending order, or by a comparison function, in O(n log n).
+ *     isSorted
+ *       Function to state whether the array elements are in ascending order or not.
+ *     search
+ *       Searches the array for a specified value.
+ *     count
+ *       Returns the number of elements equal to a specified value.
+ *     swap
+ *       Swaps array data with another array.
+ *
+ */
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class CustomSmallArray;
+
+/*
+ *
+ * template <typename T, std::size_t N, typename Allocator>
+ * std::ostream& operator<<(std::ostream& out, const CustomSmallArray<T, N, Allocator>& arr);
+ *
+ * Summary:
+ *
+ *    Standard output operator overload for a CustomSmallArray array object.
+ *
+ * Return Value: None
+ *
+ * Description:
+ *
+ *   Standard output operator overload that has friend privileges within the CustomSmallArray class.
+ *   Calls the private member function display.
+ *
+ */
+template <typename T, std::size_t N, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomSmallArray<T, N, Allocator>& arr);
+
+
+// Forward declaration of template friend functions ends here.
+
+
+template <typename T, std::size_t N, typename Allocator>
+class CustomSmallArray
+{
+private:
+
+    static_assert(N > 0, "CustomSmallArray must hold at least one element inline.");
+
+    std::size_t m_length{};
+    std::size_t m_capacity{ N };
+    T* m_array_ptr{ inlineData() };
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    Allocator m_allocator{};
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename AllocTraits::value_type, T>::value,
+                  "Allocator::value_type must be the same as the element type.");
+    static_assert(std::is_same<typename AllocTraits::pointer, T*>::value,
+                  "Allocator must allocate raw pointers.");
+
+    T* inlineData() { return reinterpret_cast<T*>(m_inline); }
+    bool isInline() const { return m_array_ptr == reinterpret_cast<const T*>(m_inline); }
+
+    /*
+     *
+     * void constructMoves(T* first, T* last, T* destination);
+     * void destroyRange(T* first, T* last);
+     *
+     * Summary:
+     *
+     *   Move elements into uninitialised memory, and destroy elements.
+     *
+     * Parameters   : T* first, T* last, T* destination
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   constructMoves move-constructs the elements [first, last) in the uninitialised memory at destination,
+     *   using std::move_if_noexcept, so that the elements [first, last) are unchanged if an exception is thrown.
+     *   Trivially copyable elements are copied with a single std::memcpy.
+     *   destroyRange destroys the elements [first, last). Trivially destructible elements are left alone.
+     *
+     */
+    void constructMoves(T* first, T* last, T* destination);
+    void destroyRange(T* first, T* last);
+
+    /*
+     *
+     * void reallocate(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Moves the array data into memory of the specified capacity.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If capacity is no greater than N, moves the elements back into m_inline. Else, allocates heap memory
+     *   for capacity elements and moves the elements into it, using constructMoves.
+     *   Destroys the existing elements, and deallocates the existing memory if it was on the heap.
+     *   capacity must be no less than the length of the array.
+     *
+     */
+    void reallocate(std::size_t capacity);
+
+    // Returns the capacity to grow to when the memory is full. Doubles the current capacity, or returns minimum.
+    std::size_t nextCapacity(std::size_t minimum) const;
+
+    // Called by the overloaded operator << friend function.
+    std::ostream& display(std::ostream& out) const;
+
+public:
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomSmallArray() noexcept;
+
+    // Initialises an empty array that allocates any heap memory with allocator.
+    explicit CustomSmallArray(const Allocator& allocator) noexcept;
+
+    // Initialises an array from a std::initializer_list.
+    CustomSmallArray(std::initializer_list<T> elements, const Allocator& allocator = Allocator{}) noexcept;
+
+    /*
+     *
+     * CustomSmallArray(const CustomSmallArray<T, N, Allocator>& other) noexcept;
+     *
+     * Summary:
+     *
+     *   Initialises an array from another array.
+     *
+     * Parameters: const CustomSmallArray<T, N, Allocator>& other
+     *
+     * Description:
+     *
+     *   Copies the elements of other into m_inline, or into heap memory if other holds more than N elements.
+     *
+     */
+    CustomSmallArray(const CustomSmallArray<T, N, Allocator>& other) noexcept;
+
+    /*
+     *
+     * CustomSmallArray(CustomSmallArray<T, N, Allocator>&& other) noexcept;
+     *
+     * Summary:
+     *
+     *   Initialises an array from another array, using move semantics.
+     *
+     * Parameters: CustomSmallArray<T, N, Allocator>&& other
+     *
+     * Description:
+     *
+     *   If the elements of other are on the heap, takes the heap memory of other. Else, the elements are
+     *   stored inside other, so each element is moved into m_inline.
+     *   other is left empty.
+     *
+     */
+    CustomSmallArray(CustomSmallArray<T, N, Allocator>&& other) noexcept;
+
+    // Initialises an array from two iterators that are compatible with containers in the standard library.
+    template <typename InputIterator>
+    CustomSmallArray(InputIterator first, InputIterator last, const Allocator& allocator = Allocator{}) noexcept;
+
+    // Destroys the elements, and frees any heap memory.
+    ~CustomSmallArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return m_length; }
+    bool empty() const { return !m_length; }
+    std::size_t capacity() const { return m_capacity; }
+    T* data() { return m_array_ptr; }
+    const T* data() const { return m_array_ptr; }
+    bool isSmall() const { return isInline(); }
+    Allocator getAllocator() const { return m_allocator; }
+
+    /*
+     *
+     * void reserve(std::size_t capacity);
+     *
+     * Summary:
+     *
+     *   Allocates memory for at least the specified number of elements.
+     *
+     * Parameters   : std::size_t capacity
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If capacity is greater than the current capacity, moves the elements to heap memory of that capacity.
+     *   An array never allocates memory for N elements or fewer.
+     *
+     */
+    void reserve(std::size_t capacity);
+
+    /*
+     *
+     * void shrinkToFit();
+     *
+     * Summary:
+     *
+     *   Releases any heap memory that is not used by the array elements.
+     *
+     * Parameters   : None
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If the array holds N elements or fewer, moves them back into m_inline and frees the heap memory.
+     *   Else, moves them into heap memory that holds exactly the current length.
+     *
+     */
+    void shrinkToFit();
+
+    // Destroys the elements and frees any heap memory, so the array stores its elements inline again.
+    void clear();
+
+    /*
+     *
+     * void resize(std::size_t length);
+     *
+     * Summary:
+     *
+     *   Resize function. All elements are kept in the array up to the new length.
+     *
+     * Parameters   : std::size_t length
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   New elements are value-initialised. Elements beyond the new length are destroyed.
+     *   The capacity only grows. If an exception is caught, the length of the array is unchanged.
+     *
+     */
+    void resize(std::size_t length);
+
+    // Copies value into the array at position. Support negative indexing!
+    void insert(int position, const T& value);
+
+    /*
+     *
+     * template <typename... Args>
+     * void emplace(int position, Args&&... args);
+     *
+     * Summary:
+     *
+     *   Constructs a new element in place at the specified position.
+     *
+     * Parameters   : int position, Args&&... args
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If the array is full, grows the capacity geometrically and constructs the element from args
+     *   directly in the new heap memory, before moving the existing elements around it.
+     *   Else, shifts the values after position one place to the right and constructs the element in the gap.
+     *   Increments the length by one.
+     *   Support negative indexing!
+     *
+     */
+    template <typename... Args>
+    void emplace(int position, Args&&... args);
+
+    /*
+     *
+     * void erase(int position);
+     *
+     * Summary:
+     *
+     *   Removes data from the array at the specified position.
+     *
+     * Parameters   : int position
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Shifts the values after position one place to the left, and destroys the last element.
+     *   Decrements the length by one. The capacity of the array is unchanged.
+     *   Support negative indexing!
+     *
+     */
+    void erase(int position);
+
+    // Appends value to the end of the array. Amortised O(1).
+    void pushBack(const T& value);
+    void pushBack(T&& value);
+
+    // Constructs a new element from args at the end of the array. Amortised O(1).
+    template <typename... Args>
+    void emplaceBack(Args&&... args);
+
+    // Inserts value at the start of the array. O(n), as there is no unused memory before the first element.
+    void pushFront(const T& value);
+
+    void popBack();
+    void popFront();
+    void reverse();
+
+    /*
+     *
+     * void sort();
+     * template <typename Compare>
+     * void sort(Compare comp);
+     *
+     * Summary:
+     *
+     *   Sorts the array in ascending order, or by a comparison function, in O(n log n).
+     *
+     * Parameters   : Compare comp
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Sorts the elements in place using the pattern-defeating quicksort of CustomArray.
+     *   Arrays of N elements or fewer are below the insertion sort threshold, so they are insertion sorted.
+     *
+     */
+    void sort();
+    template <typename Compare>
+    void sort(Compare comp);
+
+    // Returns whether the elements are in ascending order. O(n).
+    bool isSorted() const;
+
+    /*
+     *
+     * int search(const T& value) const;
+     *
+     * Summary:
+     *
+     *   Searches the array for a specified value.
+     *
+     * Parameters   : const T& value
+     *
+     * Return Value : int position
+     *
+     * Description:
+     *
+     *   Returns the position of the first element equal to value, or -1 if no element is equal to value.
+     *   Searches linearly using simdFind, as a short array is searched faster than its order can be checked.
+     *
+     */
+    int search(const T& value) const;
+
+    // Returns the number of elements equal to value, using simdCount.
+    std::size_t count(const T& value) const;
+
+    /*
+     *
+     * void swap(CustomSmallArray<T, N, Allocator>& other);
+     *
+     * Summary:
+     *
+     *   Swaps array data with another array.
+     *
+     * Parameters   : CustomSmallArray<T, N, Allocator>& other
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   If the elements of both arrays are on the heap, switches their pointers, lengths and capacities.
+     *   Else, elements stored inline cannot change owner, so the arrays are swapped using three moves.
+     *
+     */
+    void swap(CustomSmallArray<T, N, Allocator>& other);
+
+    // Index operator overloads. Support negative indexing!
+    T& operator[](int position);
+    const T& operator[](int position) const;
+
+    // Copy assignment operator overload. Copies the elements of other.
+    CustomSmallArray& operator=(const CustomSmallArray<T, N, Allocator>& other);
+
+    // Move assignment operator overload. Takes the heap memory of other, or moves its inline elements.
+    CustomSmallArray& operator=(CustomSmallArray<T, N, Allocator>&& other);
+
+    // Copy assignment operator overload from a std::initializer_list.
+    CustomSmallArray& operator=(std::initializer_list<T> elements);
+
+    // Fully specialised template friend function declarations.
+    friend std::ostream& operator<<<T, N, Allocator>(std::ostream& out, const CustomSmallArray<T, N, Allocator>& arr);
+
+    // The iterators of CustomArray, so that code written for either array works with both.
+    using Iterator = typename CustomArray<T, Allocator>::Iterator;
+    using ConstIterator = typename CustomArray<T, Allocator>::ConstIterator;
+
+    Iterator begin() { return Iterator{ m_array_ptr }; }
+    Iterator end() { return Iterator{ m_array_ptr + m_length }; }
+    ConstIterator begin() const { return ConstIterator{ m_array_ptr }; }
+    ConstIterator end() const { return ConstIterator{ m_array_ptr + m_length }; }
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::constructMoves(T* first, T* last, T* destination)
+{
+    if (std::is_trivially_copyable<T>::value)
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void*>(destination), first, static_cast<std::size_t>(last - first) * sizeof(T));
+        }
+        return;
+    }
+
+    T* constructed{ destination };
+    try
+    {
+        for (; first != last; ++first, ++constructed)
+        {
+            AllocTraits::construct(m_allocator, constructed, std::move_if_noexcept(*first));
+        }
+    }
+    catch (...)
+    {
+        destroyRange(destination, constructed);
+        throw;
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::destroyRange(T* first, T* last)
+{
+    if (std::is_trivially_destructible<T>::value) { return; }
+
+    for (; first != last; ++first)
+    {
+        AllocTraits::destroy(m_allocator, first);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::reallocate(std::size_t capacity)
+{
+    if (capacity <= N && isInline()) { return; }
+
+    T* new_array_ptr{ (capacity <= N) ? inlineData() : AllocTraits::allocate(m_allocator, capacity) };
+    try
+    {
+        constructMoves(m_array_ptr, m_array_ptr + m_length, new_array_ptr);
+    }
+    catch (...)
+    {
+        if (capacity > N) { AllocTraits::deallocate(m_allocator, new_array_ptr, capacity); }
+        throw;
+    }
+    destroyRange(m_array_ptr, m_array_ptr + m_length);
+    if (!isInline()) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+    m_array_ptr = new_array_ptr;
+    m_capacity = (capacity <= N) ? N : capacity;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t CustomSmallArray<T, N, Allocator>::nextCapacity(std::size_t minimum) const
+{
+    std::size_t grown{ m_capacity * 2 };
+    return (grown > minimum) ? grown : minimum;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::ostream& CustomSmallArray<T, N, Allocator>::display(std::ostream& out) const
+{
+    // Characters are printed as a string, without spaces.
+    const char* separator{ std::is_same<T, char>::value ? "" : " " };
+    for (std::size_t position{ 0 }; position < m_length; ++position)
+    {
+        if (position > 0) { out << separator; }
+        out << m_array_ptr[position];
+    }
+    return out;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray() noexcept
+{
+    std::cout << "CustomSmallArray default constructor called.\n";
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray(const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomSmallArray (allocator) constructor called.\n";
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray(std::initializer_list<T> elements, const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomSmallArray list-initialised constructor called.\n";
+    reserve(elements.size());
+    for (const T& element : elements)
+    {
+        emplaceBack(element);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray(const CustomSmallArray<T, N, Allocator>& other) noexcept
+    : m_allocator{ AllocTraits::select_on_container_copy_construction(other.m_allocator) }
+{
+    std::cout << "CustomSmallArray copy constructor called.\n";
+    reserve(other.m_length);
+    for (std::size_t position{ 0 }; position < other.m_length; ++position)
+    {
+        emplaceBack(other.m_array_ptr[position]);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray(CustomSmallArray<T, N, Allocator>&& other) noexcept
+    : m_allocator{ std::move(other.m_allocator) }
+{
+    std::cout << "CustomSmallArray move constructor called.\n";
+    if (other.isInline())
+    {
+        constructMoves(other.m_array_ptr, other.m_array_ptr + other.m_length, m_array_ptr);
+        m_length = other.m_length;
+        other.clear();
+        return;
+    }
+
+    m_array_ptr = other.m_array_ptr;
+    m_length = other.m_length;
+    m_capacity = other.m_capacity;
+    other.m_array_ptr = other.inlineData();
+    other.m_length = 0;
+    other.m_capacity = N;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename InputIterator>
+CustomSmallArray<T, N, Allocator>::CustomSmallArray(InputIterator first, InputIterator last,
+                                                    const Allocator& allocator) noexcept
+    : m_allocator{ allocator }
+{
+    std::cout << "CustomSmallArray (iterator) copy constructor called.\n";
+    while (first != last)
+    {
+        emplaceBack(*first);
+        ++first;
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>::~CustomSmallArray() noexcept
+{
+    std::cout << "CustomSmallArray destructor called.\n";
+    clear();
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename T, std::size_t N, typename Allocator>
+T& CustomSmallArray<T, N, Allocator>::operator[](int position)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    return m_array_ptr[position];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+const T& CustomSmallArray<T, N, Allocator>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    return m_array_ptr[position];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>& CustomSmallArray<T, N, Allocator>::operator=(const CustomSmallArray<T, N, Allocator>& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    reserve(other.m_length);
+    for (std::size_t position{ 0 }; position < other.m_length; ++position)
+    {
+        emplaceBack(other.m_array_ptr[position]);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>& CustomSmallArray<T, N, Allocator>::operator=(CustomSmallArray<T, N, Allocator>&& other)
+{
+    if (this == &other) { return *this; }
+
+    clear();
+    if (other.isInline() || !(m_allocator == other.m_allocator))
+    {
+        reserve(other.m_length);
+        constructMoves(other.m_array_ptr, other.m_array_ptr + other.m_length, m_array_ptr);
+        m_length = other.m_length;
+        other.clear();
+        return *this;
+    }
+
+    m_array_ptr = other.m_array_ptr;
+    m_length = other.m_length;
+    m_capacity = other.m_capacity;
+    other.m_array_ptr = other.inlineData();
+    other.m_length = 0;
+    other.m_capacity = N;
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+CustomSmallArray<T, N, Allocator>& CustomSmallArray<T, N, Allocator>::operator=(std::initializer_list<T> elements)
+{
+    clear();
+    reserve(elements.size());
+    for (const T& element : elements)
+    {
+        emplaceBack(element);
+    }
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::reserve(std::size_t capacity)
+{
+    if (capacity > m_capacity)
+    {
+        reallocate(capacity);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::shrinkToFit()
+{
+    if (isInline() || m_capacity == m_length) { return; }
+
+    reallocate(m_length);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::clear()
+{
+    destroyRange(m_array_ptr, m_array_ptr + m_length);
+    if (!isInline()) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+    m_array_ptr = inlineData();
+    m_length = 0;
+    m_capacity = N;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::resize(std::size_t length)
+{
+    try
+    {
+        reserve(length);
+        while (m_length < length)
+        {
+            emplaceBack();
+        }
+        destroyRange(m_array_ptr + length, m_array_ptr + m_length);
+        m_length = length;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Standard exception caught: " << e.what() << "\n"
+                  << "Length of array remains " << size() << "\n";
+        return;
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::insert(int position, const T& value)
+{
+    emplace(position, value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+void CustomSmallArray<T, N, Allocator>::emplace(int position, Args&&... args)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    if (position > static_cast<int>(m_length))
+    {
+        position = static_cast<int>(m_length);
+    }
+
+    if (m_length == m_capacity)
+    {
+        // args may refer to an element of this array, so the element is constructed before the old memory is freed.
+        std::size_t new_capacity{ nextCapacity(m_length + 1) };
+        T* new_array_ptr{ AllocTraits::allocate(m_allocator, new_capacity) };
+        T* inserted_ptr{ new_array_ptr + position };
+        try
+        {
+            AllocTraits::construct(m_allocator, inserted_ptr, std::forward<Args>(args)...);
+            try
+            {
+                constructMoves(m_array_ptr, m_array_ptr + position, new_array_ptr);
+                try
+                {
+                    constructMoves(m_array_ptr + position, m_array_ptr + m_length, inserted_ptr + 1);
+                }
+                catch (...)
+                {
+                    destroyRange(new_array_ptr, inserted_ptr);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                destroyRange(inserted_ptr, inserted_ptr + 1);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            AllocTraits::deallocate(m_allocator, new_array_ptr, new_capacity);
+            throw;
+        }
+        destroyRange(m_array_ptr, m_array_ptr + m_length);
+        if (!isInline()) { AllocTraits::deallocate(m_allocator, m_array_ptr, m_capacity); }
+        m_array_ptr = new_array_ptr;
+        m_capacity = new_capacity;
+        ++m_length;
+        return;
+    }
+
+    if (position == static_cast<int>(m_length))
+    {
+        AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::forward<Args>(args)...);
+        ++m_length;
+        return;
+    }
+
+    // args may refer to an element of this array, so the element is constructed before any data is moved.
+    T temp(std::forward<Args>(args)...);
+    AllocTraits::construct(m_allocator, m_array_ptr + m_length, std::move(m_array_ptr[m_length - 1]));
+    ++m_length;
+    for (int after{ static_cast<int>(m_length) - 2 }; after > position; --after)
+    {
+        m_array_ptr[after] = std::move(m_array_ptr[after - 1]);
+    }
+    m_array_ptr[position] = std::move(temp);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::erase(int position)
+{
+    if (empty()) { return; }
+
+    if (position < 0)
+    {
+        position = static_cast<int>(m_length) - (abs(position) % static_cast<int>(m_length));
+    }
+    if (position >= static_cast<int>(m_length))
+    {
+        position = static_cast<int>(m_length) - 1;
+    }
+
+    for (int after{ position + 1 }; after < static_cast<int>(m_length); ++after)
+    {
+        m_array_ptr[after - 1] = std::move(m_array_ptr[after]);
+    }
+    --m_length;
+    AllocTraits::destroy(m_allocator, m_array_ptr + m_length);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::pushBack(const T& value)
+{
+    emplace(static_cast<int>(m_length), value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::pushBack(T&& value)
+{
+    emplace(static_cast<int>(m_length), std::move(value));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+void CustomSmallArray<T, N, Allocator>::emplaceBack(Args&&... args)
+{
+    emplace(static_cast<int>(m_length), std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::pushFront(const T& value)
+{
+    emplace(0, value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::popBack()
+{
+    erase(static_cast<int>(m_length));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::popFront()
+{
+    erase(0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::reverse()
+{
+    if (m_length < 2) { return; }
+
+    T* forward_ptr{ m_array_ptr };
+    T* backward_ptr{ m_array_ptr + m_length - 1 };
+    while (forward_ptr < backward_ptr)
+    {
+        std::swap(*forward_ptr++, *backward_ptr--);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::sort()
+{
+    sort([](const T& a, const T& b) { return a < b; });
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Compare>
+void CustomSmallArray<T, N, Allocator>::sort(Compare comp)
+{
+    if (m_length < 2) { return; }
+
+    // badAllowed is log2(n), the number of unbalanced partitions tolerated before falling back to heapSort.
+    int badAllowed{ 0 };
+    for (std::size_t length{ m_length }; length > 1; length >>= 1)
+    {
+        ++badAllowed;
+    }
+    CustomArray<T, Allocator>::pdqSort(m_array_ptr, m_array_ptr + m_length, comp, badAllowed, true);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+bool CustomSmallArray<T, N, Allocator>::isSorted() const
+{
+    for (std::size_t position{ 1 }; position < m_length; ++position)
+    {
+        if (m_array_ptr[position - 1] > m_array_ptr[position])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+int CustomSmallArray<T, N, Allocator>::search(const T& value) const
+{
+    std::size_t position{ simdFind(m_array_ptr, m_length, value) };
+    return (position < m_length) ? static_cast<int>(position) : -1;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t CustomSmallArray<T, N, Allocator>::count(const T& value) const
+{
+    return simdCount(m_array_ptr, m_length, value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void CustomSmallArray<T, N, Allocator>::swap(CustomSmallArray<T, N, Allocator>& other)
+{
+    if (this == &other) { return; }
+
+    if (!isInline() && !other.isInline() && m_allocator == other.m_allocator)
+    {
+        std::swap(m_array_ptr, other.m_array_ptr);
+        std::swap(m_length, other.m_length);
+        std::swap(m_capacity, other.m_capacity);
+        return;
+    }
+
+    CustomSmallArray<T, N, Allocator> temp{ std::move(other) };
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+// Public member functions definitions end here.
+
+// Friend function definitions begin here.
+
+template <typename T, std::size_t N, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const CustomSmallArray<T, N, Allocator>& arr)
+{
+    return arr.display(out);
+}
+
+// Friend functions definitions end here.
+
+#endif // CUSTOMSMALLARRAY_H_INCLUDED
@@ -0,0 +1,450 @@
+#ifndef CUSTOMSOAARRAY_H_INCLUDED
+#define CUSTOMSOAARRAY_H_INCLUDED
+
+#include <iostream>
+#include <cstddef>     // std::size_t
+#include <tuple>       // std::tuple, std::get, std::tuple_element
+#include <utility>     // std::index_sequence, std::move
+#include <iterator>    // std::bidirectional_iterator_tag
+#include <type_traits> // std::conditional, std::is_const
+#include "CustomArray.h"
+#include "CustomArrayView.h"
+
+
+/*
+ *
+ * File:    CustomSoAArray.h
+ *
+ * Author:  Alexander R.
+ * Date:    2023
+ *
+ * Summary of File:
+ *
+ *   This file contains code for a structure of arrays container in the form of a class template CustomSoAArray.
+ *
+ *   A CustomSoAArray<Fields...> stores records with one field of each type in Fields, but instead of storing
+ *   the records one after another, it keeps one CustomArray column per field. Row i is element i of every
+ *   column. A scan over one field reads only that column, so it uses every byte of each cache line it loads,
+ *   and the SIMD search and count of CustomArrayView run directly on the column.
+ *
+ *   Rows are accessed through a Row proxy object, which refers to the row's elements in each column.
+ *
+ */
+
+
+/*
+ *
+ *   Class Name: CustomSoAArray
+ *
+ *   Purpose:
+ *
+ *     A container class template that stores records as one array per field.
+ *
+ *   Member Variables:
+ *
+ *     m_columns
+ *       A std::tuple holding one CustomArray per field. Every column has the same length.
+ *
+ *   Member Functions:
+ *
+ *     columnData
+ *       Returns a pointer to the first element of a column.
+ *     truncate
+ *       Shrinks every column to a number of rows, keeping the columns the same length after a failed insertion.
+ *     size
+ *       Returns the number of rows.
+ *     empty
+ *       Returns a bool True if there are no rows.
+ *     reserve
+ *       Allocates memory in every column for at least the specified number of rows.
+ *     clear
+ *       Removes every row, and frees the memory of every column.
+ *     resize
+ *       Sets the number of rows. New rows are value initialised.
+ *     pushBack
+ *       Appends a row, given a value for each field.
+ *     popBack
+ *       Removes the last row.
+ *     erase
+ *       Removes the row at the specified position.
+ *     column
+ *       Returns a view of the column of one field.
+ *     swap
+ *       Swaps the columns of two containers.
+ *
+ */
+template <typename... Fields>
+class CustomSoAArray
+{
+private:
+
+    static_assert(sizeof...(Fields) > 0, "CustomSoAArray requires at least one field.");
+
+    std::tuple<CustomArray<Fields>...> m_columns;
+
+    template <std::size_t I>
+    using FieldType = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+    using Indices = std::index_sequence_for<Fields...>;
+
+    template <std::size_t I>
+    FieldType<I>* columnData() { return std::get<I>(m_columns).data(); }
+    template <std::size_t I>
+    const FieldType<I>* columnData() const { return std::get<I>(m_columns).data(); }
+
+    // Shrinks every column to length rows. Used to undo an insertion that did not reach every column.
+    template <std::size_t... I>
+    void truncate(std::size_t length, std::index_sequence<I...>);
+
+    template <std::size_t... I>
+    void pushBack(std::index_sequence<I...>, const Fields&... values);
+
+    template <std::size_t... I>
+    void reserve(std::size_t capacity, std::index_sequence<I...>);
+
+    template <std::size_t... I>
+    void clear(std::index_sequence<I...>);
+
+    template <std::size_t... I>
+    void resize(std::size_t length, std::index_sequence<I...>);
+
+    template <std::size_t... I>
+    void erase(int position, std::index_sequence<I...>);
+
+    /*
+     *
+     *   Class Name: RowProxy
+     *
+     *   Purpose:
+     *
+     *     Refers to one row of a CustomSoAArray. RowProxy<CustomSoAArray> is Row, and can change the row.
+     *     RowProxy<const CustomSoAArray> is ConstRow, and can only read it.
+     *
+     */
+    template <typename Owner>
+    class RowProxy
+    {
+    private:
+        Owner* m_owner_ptr;
+        std::size_t m_position;
+
+        template <std::size_t I>
+        using Field = typename std::conditional<std::is_const<Owner>::value, const FieldType<I>, FieldType<I>>::type;
+
+        template <std::size_t... I>
+        std::tuple<Fields...> load(std::index_sequence<I...>) const { return std::tuple<Fields...>{ get<I>()... }; }
+
+        template <std::size_t... I>
+        void store(const std::tuple<Fields...>& values, std::index_sequence<I...>) const
+        {
+            int expand[]{ (get<I>() = std::get<I>(values), 0)... };
+            (void)expand;
+        }
+
+    public:
+        RowProxy(Owner* owner, std::size_t position) : m_owner_ptr{ owner }, m_position{ position } {}
+
+        // Returns the field at index I of the row.
+        template <std::size_t I>
+        Field<I>& get() const { return m_owner_ptr->template columnData<I>()[m_position]; }
+
+        // Reads every field of the row into a std::tuple.
+        operator std::tuple<Fields...>() const { return load(Indices{}); }
+
+        // Writes every field of the row. Assigning one row to another copies the fields, not the reference.
+        const RowProxy& operator=(const std::tuple<Fields...>& values) const
+        {
+            static_assert(!std::is_const<Owner>::value, "A ConstRow cannot be assigned to.");
+            store(values, Indices{});
+            return *this;
+        }
+        const RowProxy& operator=(const RowProxy& other) const { return *this = static_cast<std::tuple<Fields...>>(other); }
+    };
+
+    /*
+     *
+     *   Class Name: RowIterator
+     *
+     *   Purpose:
+     *
+     *     A bidirectional iterator over the rows of a CustomSoAArray, which dereferences to a Row or ConstRow.
+     *
+     */
+    template <typename Owner>
+    class RowIterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::tuple<Fields...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = RowProxy<Owner>;
+    private:
+        Owner* m_owner_ptr;
+        std::size_t m_position;
+    public:
+        RowIterator(Owner* owner, std::size_t position) : m_owner_ptr{ owner }, m_position{ position } {}
+        reference operator*() const { return reference{ m_owner_ptr, m_position }; }
+        RowIterator& operator++() { ++m_position; return *this; }
+        RowIterator operator++(int) { RowIterator temp{ *this }; ++m_position; return temp; }
+        RowIterator& operator--() { --m_position; return *this; }
+        RowIterator operator--(int) { RowIterator temp{ *this }; --m_position; return temp; }
+        friend bool operator==(const RowIterator& a, const RowIterator& b) { return a.m_position == b.m_position; }
+        friend bool operator!=(const RowIterator& a, const RowIterator& b) { return a.m_position != b.m_position; }
+    };
+
+public:
+
+    using Row = RowProxy<CustomSoAArray<Fields...>>;
+    using ConstRow = RowProxy<const CustomSoAArray<Fields...>>;
+    using Iterator = RowIterator<CustomSoAArray<Fields...>>;
+    using ConstIterator = RowIterator<const CustomSoAArray<Fields...>>;
+
+    // An overloaded default constructor that writes a message to the standard output.
+    CustomSoAArray();
+
+    // Copy and move constructors, which copy or move every column.
+    CustomSoAArray(const CustomSoAArray<Fields...>& other);
+    CustomSoAArray(CustomSoAArray<Fields...>&& other) noexcept;
+
+    ~CustomSoAArray() noexcept;
+
+    // Public member function declarations.
+    std::size_t size() const { return std::get<0>(m_columns).size(); }
+    bool empty() const { return !size(); }
+
+    void reserve(std::size_t capacity) { reserve(capacity, Indices{}); }
+    void clear() { clear(Indices{}); }
+
+    // Sets the number of rows. New rows are value initialised. If a column cannot grow, every column keeps its length.
+    void resize(std::size_t length) { resize(length, Indices{}); }
+
+    /*
+     *
+     * void pushBack(const Fields&... values);
+     *
+     * Summary:
+     *
+     *   Appends a row, given a value for each field.
+     *
+     * Parameters   : const Fields&... values
+     *
+     * Return Value : None
+     *
+     * Description:
+     *
+     *   Appends each value to the end of its column. If a column could not grow, the columns that did are
+     *   shrunk again, so every column keeps the same length.
+     *
+     */
+    void pushBack(const Fields&... values) { pushBack(Indices{}, values...); }
+
+    void popBack();
+
+    // Removes the row at position from every column. Supports negative indexing.
+    void erase(int position) { erase(position, Indices{}); }
+
+    /*
+     *
+     * template <std::size_t I>
+     * CustomArrayView<FieldType<I>> column();
+     * template <std::size_t I>
+     * CustomArrayView<const FieldType<I>> column() const;
+     *
+     * Summary:
+     *
+     *   Returns a view of the column of field I.
+     *
+     * Return Value : CustomArrayView view
+     *
+     * Description:
+     *
+     *   The view holds one element per row, contiguous in memory, so it can be scanned, searched, counted or
+     *   sorted without touching the other fields. Sorting a column reorders that field only, not the rows.
+     *   The view is invalidated when rows are added or removed.
+     *
+     */
+    template <std::size_t I>
+    CustomArrayView<FieldType<I>> column() { return CustomArrayView<FieldType<I>>{ columnData<I>(), size() }; }
+    template <std::size_t I>
+    CustomArrayView<const FieldType<I>> column() const { return CustomArrayView<const FieldType<I>>{ columnData<I>(), size() }; }
+
+    void swap(CustomSoAArray<Fields...>& other) { m_columns.swap(other.m_columns); }
+
+    // Index operator overloads. Return a proxy for the row at position. Support negative indexing!
+    Row operator[](int position);
+    ConstRow operator[](int position) const;
+
+    // Copy and move assignment operator overloads, which assign every column.
+    CustomSoAArray& operator=(const CustomSoAArray<Fields...>& other);
+    CustomSoAArray& operator=(CustomSoAArray<Fields...>&& other) noexcept;
+
+    Iterator begin() { return Iterator{ this, 0 }; }
+    Iterator end() { return Iterator{ this, size() }; }
+    ConstIterator begin() const { return ConstIterator{ this, 0 }; }
+    ConstIterator end() const { return ConstIterator{ this, size() }; }
+
+};
+
+
+// Private member function definitions begin here.
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::truncate(std::size_t length, std::index_sequence<I...>)
+{
+    int expand[]{ (std::get<I>(m_columns).size() > length ? std::get<I>(m_columns).resize(length) : void(), 0)... };
+    (void)expand;
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::pushBack(std::index_sequence<I...>, const Fields&... values)
+{
+    std::size_t length{ size() };
+    try
+    {
+        int expand[]{ (std::get<I>(m_columns).pushBack(values), 0)... };
+        (void)expand;
+    }
+    catch (...)
+    {
+        truncate(length, Indices{});
+        throw;
+    }
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::reserve(std::size_t capacity, std::index_sequence<I...>)
+{
+    int expand[]{ (std::get<I>(m_columns).reserve(capacity), 0)... };
+    (void)expand;
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::clear(std::index_sequence<I...>)
+{
+    int expand[]{ (std::get<I>(m_columns).clear(), 0)... };
+    (void)expand;
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::resize(std::size_t length, std::index_sequence<I...>)
+{
+    std::size_t previous{ size() };
+    try
+    {
+        int expand[]{ (std::get<I>(m_columns).resize(length), 0)... };
+        (void)expand;
+    }
+    catch (...)
+    {
+        truncate(previous, Indices{});
+        throw;
+    }
+
+    // CustomArray::resize reports a standard exception instead of throwing it, leaving that column's length unchanged.
+
+    bool complete{ true };
+    int check[]{ (complete = complete && std::get<I>(m_columns).size() == length, 0)... };
+    (void)check;
+    if (!complete)
+    {
+        truncate(previous, Indices{});
+    }
+}
+
+template <typename... Fields>
+template <std::size_t... I>
+void CustomSoAArray<Fields...>::erase(int position, std::index_sequence<I...>)
+{
+    int expand[]{ (std::get<I>(m_columns).erase(position), 0)... };
+    (void)expand;
+}
+
+// Private member function definitions end here.
+
+// Constructor and Destructor definitions begin here.
+
+template <typename... Fields>
+CustomSoAArray<Fields...>::CustomSoAArray()
+{
+    std::cout << "CustomSoAArray default constructor called.\n";
+}
+
+template <typename... Fields>
+CustomSoAArray<Fields...>::CustomSoAArray(const CustomSoAArray<Fields...>& other)
+    : m_columns{ other.m_columns }
+{
+    std::cout << "CustomSoAArray copy constructor called.\n";
+}
+
+template <typename... Fields>
+CustomSoAArray<Fields...>::CustomSoAArray(CustomSoAArray<Fields...>&& other) noexcept
+    : m_columns{ std::move(other.m_columns) }
+{
+    std::cout << "CustomSoAArray move constructor called.\n";
+}
+
+template <typename... Fields>
+CustomSoAArray<Fields...>::~CustomSoAArray() noexcept
+{
+    std::cout << "CustomSoAArray destructor called.\n";
+}
+
+// Constructor and Destructor definitions end here.
+
+// Operator overload definitions begin here.
+
+template <typename... Fields>
+typename CustomSoAArray<Fields...>::Row CustomSoAArray<Fields...>::operator[](int position)
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return Row{ this, static_cast<std::size_t>(position) };
+}
+
+template <typename... Fields>
+typename CustomSoAArray<Fields...>::ConstRow CustomSoAArray<Fields...>::operator[](int position) const
+{
+    if (position < 0)
+    {
+        position = static_cast<int>(size()) - (abs(position) % static_cast<int>(size()));
+    }
+    return ConstRow{ this, static_cast<std::size_t>(position) };
+}
+
+template <typename... Fields>
+CustomSoAArray<Fields...>& CustomSoAArray<Fields...>::operator=(const CustomSoAArray<Fields...>& other)
+{
+    CustomSoAArray<Fields...> temp{ other };
+    swap(temp);
+    return *this;
+}
+
+template <typename... Fields>
+CustomSoAArray<Fields...>& CustomSoAArray<Fields...>::operator=(CustomSoAArray<Fields...>&& other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+// Operator overload definitions end here.
+
+// Public member functions definitions begin here.
+
+template <typename... Fields>
+void CustomSoAArray<Fields...>::popBack()
+{
+    if (!empty())
+    {
+        truncate(size() - 1, Indices{});
+    }
+}
+
+// Public member functions definitions end here.
+
+#endif // CUSTOMSOAARRAY_H_INCLUDED